@@ -13,35 +13,80 @@
 #include <zmk/events/keycode_state_changed.h>
 #include <zmk/events/position_state_changed.h>
 #include <zmk/events/activity_state_changed.h>
+#include <zmk/events/endpoint_changed.h>
 #include <zmk/events/split_peripheral_status_changed.h>
+#include <zmk/events/usb_conn_state_changed.h>
+#include <zmk/endpoints.h>
 #include <zmk/usb.h>
 
+#include "hot_path.h"
+#include "motion_gate.h"
+#include "power_mode_changed.h"
+#include "power_policy.h"
+#include "split_power_mgmt.h"
+
 LOG_MODULE_REGISTER(split_power_mgmt, CONFIG_ZMK_LOG_LEVEL);
 
-#define SLEEP1_TIMEOUT_MS 5000   // 5 seconds to sleep1 from active
-#define SLEEP2_TIMEOUT_MS 15000  // 15 seconds to sleep2 from sleep1  
-#define SLEEP3_TIMEOUT_MS 30000  // 30 seconds to sleep3 from sleep2
 #define ACTIVE_CONN_INTERVAL CONFIG_ZMK_SPLIT_BLE_PREF_INT
-#define SLEEP1_CONN_INTERVAL (CONFIG_ZMK_SPLIT_BLE_PREF_INT*2)
-#define SLEEP2_CONN_INTERVAL (CONFIG_ZMK_SPLIT_BLE_PREF_INT*4)
-#define SLEEP3_CONN_INTERVAL (CONFIG_ZMK_SPLIT_BLE_PREF_INT*8)
 #define CONN_LATENCY CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY
-#define SLEEP1_CONN_LATENCY ((CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY+1)/2)
-#define SLEEP2_CONN_LATENCY ((CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY+3)/4)  
-#define SLEEP3_CONN_LATENCY ((CONFIG_ZMK_SPLIT_BLE_PREF_LATENCY+7)/8) 
 #define SUPERVISION_TIMEOUT CONFIG_ZMK_SPLIT_BLE_PREF_TIMEOUT
+#define USB_RETRY_MS 1000
 
-enum power_mode {
-    POWER_MODE_ACTIVE,
-    POWER_MODE_SLEEP1,
-    POWER_MODE_SLEEP2,
-    POWER_MODE_SLEEP3,
-};
-
+static struct power_policy policy = POWER_POLICY_DEFAULT;
 static struct k_work_delayable power_mode_work;
 static enum power_mode current_mode = POWER_MODE_ACTIVE;
 static int64_t last_activity_time = 0;
 static struct bt_conn *split_conn = NULL;
+static int64_t residency_ms[POWER_MODE_COUNT];
+static int64_t mode_entered_time = 0;
+
+HOT_PATH_BENCH_DEFINE(position_bench);
+HOT_PATH_BENCH_DEFINE(motion_bench);
+
+static void set_current_mode(enum power_mode mode) {
+    int64_t now = k_uptime_get();
+
+    residency_ms[current_mode] += now - mode_entered_time;
+    mode_entered_time = now;
+
+    if (mode != current_mode) {
+        current_mode = mode;
+        raise_torabo_power_mode_changed((struct torabo_power_mode_changed){.mode = mode});
+    }
+}
+
+void split_power_mgmt_get_residency(int64_t out[POWER_MODE_COUNT]) {
+    int64_t now = k_uptime_get();
+
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        out[mode] = residency_ms[mode];
+    }
+    out[current_mode] += now - mode_entered_time;
+}
+
+static int enter_mode(enum power_mode mode) {
+    struct bt_le_conn_param param;
+
+    power_policy_conn_param(&policy, mode, ACTIVE_CONN_INTERVAL, CONN_LATENCY,
+                            &param.interval_min, &param.latency);
+    param.interval_max = param.interval_min;
+    param.timeout = SUPERVISION_TIMEOUT;
+
+    int err = bt_conn_le_param_update(split_conn, &param);
+    if (err == 0) {
+        set_current_mode(mode);
+    }
+
+    return err;
+}
+
+// A sleeping host suspends USB but keeps VBUS up. Nothing is sent to it
+// until a keypress has woken it through remote wakeup, so the split link
+// can sit in its deepest tier. This only holds while reports go to USB; with
+// a BLE host selected, the suspended USB host says nothing about it.
+static bool usb_suspended(void) {
+    return IS_ENABLED(CONFIG_TORABO_USB_SUSPEND_TIER) && zmk_usb_get_status() == USB_DC_SUSPEND;
+}
 
 // Power mode transition handler
 static void power_mode_transition(struct k_work *work) {
@@ -49,120 +94,49 @@ static void power_mode_transition(struct k_work *work) {
         return;
     }
     
-    // Stay in active mode when USB power is connected
-    if (zmk_usb_is_powered()) {
-        LOG_DBG("USB power detected, staying in active mode");
-        if (current_mode != POWER_MODE_ACTIVE) {
-            // Return to active mode
-            struct bt_le_conn_param param = {
-                .interval_min = ACTIVE_CONN_INTERVAL,
-                .interval_max = ACTIVE_CONN_INTERVAL,
-                .latency = CONN_LATENCY,
-                .timeout = SUPERVISION_TIMEOUT,
-            };
-            
-            int err = bt_conn_le_param_update(split_conn, &param);
+    // On USB power the tier follows the USB state, and is re-evaluated when
+    // it or the endpoint changes. A suspended bus while reports go to BLE
+    // leaves the tier to idle time as on battery.
+    if (zmk_usb_is_powered() &&
+        (!usb_suspended() || zmk_endpoints_selected().transport == ZMK_TRANSPORT_USB)) {
+        enum power_mode usb_mode = usb_suspended() ? POWER_MODE_SLEEP3 : POWER_MODE_ACTIVE;
+
+        if (current_mode != usb_mode) {
+            int err = enter_mode(usb_mode);
             if (err == 0) {
-                current_mode = POWER_MODE_ACTIVE;
-                LOG_INF("Returned to active mode due to USB power");
+                LOG_INF("%s mode activated on USB %s", power_mode_name(usb_mode),
+                        usb_suspended() ? "suspend" : "power");
+            } else {
+                LOG_WRN("Failed to update connection parameters on USB power: %d", err);
+                k_work_schedule(&power_mode_work, K_MSEC(USB_RETRY_MS));
             }
         }
-        
-        // Periodic check while USB power is present
-        k_work_schedule(&power_mode_work, K_MSEC(5000));
         return;
     }
     
     int64_t idle_time = k_uptime_get() - last_activity_time;
-    enum power_mode target_mode;
-    
-    // Determine target mode based on idle time
-    if (idle_time >= SLEEP3_TIMEOUT_MS) {
-        target_mode = POWER_MODE_SLEEP3;
-    } else if (idle_time >= SLEEP2_TIMEOUT_MS) {
-        target_mode = POWER_MODE_SLEEP2;
-    } else if (idle_time >= SLEEP1_TIMEOUT_MS) {
-        target_mode = POWER_MODE_SLEEP1;
-    } else {
-        target_mode = POWER_MODE_ACTIVE;
-    }
+    enum power_mode target_mode = power_policy_target_mode(&policy, idle_time);
     
     // Only update if different from current mode
     if (target_mode == current_mode) {
         // Schedule next transition
-        int32_t next_timeout;
-        switch (current_mode) {
-        case POWER_MODE_ACTIVE:
-            next_timeout = SLEEP1_TIMEOUT_MS - idle_time;
-            break;
-        case POWER_MODE_SLEEP1:
-            next_timeout = SLEEP2_TIMEOUT_MS - idle_time;
-            break;
-        case POWER_MODE_SLEEP2:
-            next_timeout = SLEEP3_TIMEOUT_MS - idle_time;
-            break;
-        default:
-            return; // No further transitions from SLEEP3
-        }
-        
+        int32_t next_timeout = power_policy_next_timeout(&policy, current_mode, idle_time);
         if (next_timeout > 0) {
             k_work_schedule(&power_mode_work, K_MSEC(next_timeout));
         }
         return;
     }
     
-    // Configure connection parameters
-    struct bt_le_conn_param param;
-    const char *mode_name;
-    
-    switch (target_mode) {
-    case POWER_MODE_ACTIVE:
-        param.interval_min = param.interval_max = ACTIVE_CONN_INTERVAL;
-        param.latency = CONN_LATENCY;
-        mode_name = "active";
-        break;
-    case POWER_MODE_SLEEP1:
-        param.interval_min = param.interval_max = SLEEP1_CONN_INTERVAL;
-        param.latency = SLEEP1_CONN_LATENCY;
-        mode_name = "sleep1";
-        break;
-    case POWER_MODE_SLEEP2:
-        param.interval_min = param.interval_max = SLEEP2_CONN_INTERVAL;
-        param.latency = SLEEP2_CONN_LATENCY;
-        mode_name = "sleep2";
-        break;
-    case POWER_MODE_SLEEP3:
-        param.interval_min = param.interval_max = SLEEP3_CONN_INTERVAL;
-        param.latency = SLEEP3_CONN_LATENCY;
-        mode_name = "sleep3";
-        break;
-    }
-    
-    param.timeout = SUPERVISION_TIMEOUT;
+    const char *mode_name = power_mode_name(target_mode);
     
     LOG_INF("Entering %s mode - updating connection parameters", mode_name);
     
-    int err = bt_conn_le_param_update(split_conn, &param);
+    int err = enter_mode(target_mode);
     if (err == 0) {
-        current_mode = target_mode;
         LOG_INF("%s mode activated", mode_name);
         
         // Schedule next transition
-        int32_t next_timeout;
-        switch (current_mode) {
-        case POWER_MODE_ACTIVE:
-            next_timeout = SLEEP1_TIMEOUT_MS - idle_time;
-            break;
-        case POWER_MODE_SLEEP1:
-            next_timeout = SLEEP2_TIMEOUT_MS - idle_time;
-            break;
-        case POWER_MODE_SLEEP2:
-            next_timeout = SLEEP3_TIMEOUT_MS - idle_time;
-            break;
-        default:
-            return; // No further transitions from SLEEP3
-        }
-        
+        int32_t next_timeout = power_policy_next_timeout(&policy, current_mode, idle_time);
         if (next_timeout > 0) {
             k_work_schedule(&power_mode_work, K_MSEC(next_timeout));
         }
@@ -171,8 +145,41 @@ static void power_mode_transition(struct k_work *work) {
     }
 }
 
+static int usb_conn_state_listener(const zmk_event_t *eh) {
+    if (split_conn) {
+        k_work_reschedule(&power_mode_work, K_NO_WAIT);
+    }
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(split_power_mgmt_usb, usb_conn_state_listener);
+ZMK_SUBSCRIPTION(split_power_mgmt_usb, zmk_usb_conn_state_changed);
+ZMK_SUBSCRIPTION(split_power_mgmt_usb, zmk_endpoint_changed);
+
+// Log activity in the format tools/power_sim reads. Motion is logged at most
+// every TRACE_MOTION_MIN_MS, which is far below any tier timeout.
+#define TRACE_MOTION_MIN_MS 100
+
+static void trace_activity(char source) {
+    static int64_t last_motion_trace = 0;
+
+    if (!IS_ENABLED(CONFIG_TORABO_POWER_TRACE)) {
+        return;
+    }
+
+    int64_t now = k_uptime_get();
+    if (source == 't') {
+        if (now - last_motion_trace < TRACE_MOTION_MIN_MS) {
+            return;
+        }
+        last_motion_trace = now;
+    }
+
+    LOG_INF("trace %lld %c", now, source);
+}
+
 // Reset activity timer on user input
-static void reset_idle_timer(void) {
+static TORABO_HOT_PATH void reset_idle_timer(void) {
     LOG_DBG("Activity detected - resetting idle timer");
     last_activity_time = k_uptime_get();
     k_work_cancel_delayable(&power_mode_work);
@@ -182,12 +189,15 @@ static void reset_idle_timer(void) {
         power_mode_transition(&power_mode_work.work);
     } else {
         // Schedule transition to SLEEP1 from active mode
-        k_work_schedule(&power_mode_work, K_MSEC(SLEEP1_TIMEOUT_MS));
+        k_work_schedule(&power_mode_work, K_MSEC(policy.sleep_timeout_ms[0]));
     }
 }
 
-static int position_state_changed_listener(const zmk_event_t *eh) {
+static TORABO_HOT_PATH int position_state_changed_listener(const zmk_event_t *eh) {
+    HOT_PATH_BENCH_START(position_bench);
+    trace_activity('k');
     reset_idle_timer();
+    HOT_PATH_BENCH_END(position_bench);
     return ZMK_EV_EVENT_BUBBLE;
 }
 
@@ -216,7 +226,7 @@ static void power_mgmt_bt_conn_connected_cb(struct bt_conn *conn, uint8_t err) {
     split_conn = bt_conn_ref(conn);
     
     last_activity_time = k_uptime_get();
-    k_work_schedule(&power_mode_work, K_MSEC(SLEEP1_TIMEOUT_MS));
+    k_work_schedule(&power_mode_work, K_MSEC(policy.sleep_timeout_ms[0]));
 }
 
 static void power_mgmt_bt_conn_disconnected_cb(struct bt_conn *conn, uint8_t reason) {
@@ -229,7 +239,7 @@ static void power_mgmt_bt_conn_disconnected_cb(struct bt_conn *conn, uint8_t rea
     k_work_cancel_delayable(&power_mode_work);
     bt_conn_unref(split_conn);
     split_conn = NULL;
-    current_mode = POWER_MODE_ACTIVE;
+    set_current_mode(POWER_MODE_ACTIVE);
 }
 
 static struct bt_conn_cb power_mgmt_bt_conn_callbacks = {
@@ -237,8 +247,29 @@ static struct bt_conn_cb power_mgmt_bt_conn_callbacks = {
     .disconnected = power_mgmt_bt_conn_disconnected_cb,
 };
 
-static void mouse_input_callback(struct input_event *evt) {
+void split_power_mgmt_set_policy(const struct power_policy *new_policy) {
+    policy = *new_policy;
+
+    // Re-evaluate the current tier against the new timeouts
+    if (split_conn) {
+        k_work_reschedule(&power_mode_work, K_NO_WAIT);
+    }
+}
+
+static TORABO_HOT_PATH void mouse_input_callback(struct input_event *evt) {
+    // Motion the gate is dropping is not user activity. This relies on the
+    // listener's callback, which runs the gate, coming before this one: input
+    // callbacks run in link order, and ZMK's input_handler_N sorts first in
+    // the section. Were it the other way round, the gate state seen here
+    // would lag one event behind.
+    if (!motion_gate_is_open(evt->dev)) {
+        return;
+    }
+
+    HOT_PATH_BENCH_START(motion_bench);
+    trace_activity('t');
     reset_idle_timer();
+    HOT_PATH_BENCH_END(motion_bench);
 }
 
 static int split_power_mgmt_init(void) {
@@ -250,7 +281,7 @@ static int split_power_mgmt_init(void) {
     
     if (split_conn) {
         last_activity_time = k_uptime_get();
-        k_work_schedule(&power_mode_work, K_MSEC(SLEEP1_TIMEOUT_MS));
+        k_work_schedule(&power_mode_work, K_MSEC(policy.sleep_timeout_ms[0]));
         LOG_INF("Split power management initialized with existing connection");
     } else {
         LOG_INF("Split power management initialized - waiting for connection");
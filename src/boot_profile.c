@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/position_state_changed.h>
+
+LOG_MODULE_REGISTER(boot_profile, CONFIG_ZMK_LOG_LEVEL);
+
+// Timestamps of the boot stages up to the first keypress, which on battery
+// builds is the latency of every wake from system off. Stage boundaries are
+// taken from init hooks at the edges of the POST_KERNEL and APPLICATION
+// levels, so the time spent in each level (sensor reset, BLE stack bring-up,
+// settings load) can be read off as the difference between two lines.
+
+enum boot_stage {
+    BOOT_STAGE_POST_KERNEL,
+    BOOT_STAGE_APPLICATION,
+    BOOT_STAGE_INIT_DONE,
+    BOOT_STAGE_SETTINGS_LOADED,
+    BOOT_STAGE_FIRST_INPUT,
+    BOOT_STAGE_FIRST_KEY,
+    BOOT_STAGE_COUNT,
+};
+
+static const char *const stage_names[BOOT_STAGE_COUNT] = {
+    [BOOT_STAGE_POST_KERNEL] = "post-kernel init",
+    [BOOT_STAGE_APPLICATION] = "application init",
+    [BOOT_STAGE_INIT_DONE] = "init done",
+    [BOOT_STAGE_SETTINGS_LOADED] = "settings loaded",
+    [BOOT_STAGE_FIRST_INPUT] = "first pointer input",
+    [BOOT_STAGE_FIRST_KEY] = "first keypress",
+};
+
+// Kept in ticks, as a first keypress may come long after boot
+static int64_t stage_ticks[BOOT_STAGE_COUNT];
+static atomic_t reached = ATOMIC_INIT(0);
+
+static void mark_stage(enum boot_stage stage) {
+    if (atomic_test_and_set_bit(&reached, stage)) {
+        return;
+    }
+
+    stage_ticks[stage] = k_uptime_ticks();
+}
+
+static void boot_profile_report(struct k_work *work) {
+    int64_t prev_us = 0;
+
+    LOG_INF("Boot profile (uptime, time since previous stage):");
+    for (int i = 0; i < BOOT_STAGE_COUNT; i++) {
+        if (!atomic_test_bit(&reached, i)) {
+            continue;
+        }
+
+        int64_t us = k_ticks_to_us_floor64(stage_ticks[i]);
+
+        LOG_INF("  %-20s %6lld.%03d ms  +%lld us", stage_names[i], us / 1000, (int)(us % 1000),
+                us - prev_us);
+        prev_us = us;
+    }
+}
+
+static K_WORK_DEFINE(boot_profile_report_work, boot_profile_report);
+
+static int boot_profile_position_listener(const zmk_event_t *eh) {
+    const struct zmk_position_state_changed *ev = as_zmk_position_state_changed(eh);
+
+    if (ev->state && !atomic_test_bit(&reached, BOOT_STAGE_FIRST_KEY)) {
+        mark_stage(BOOT_STAGE_FIRST_KEY);
+        k_work_submit(&boot_profile_report_work);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(boot_profile, boot_profile_position_listener);
+ZMK_SUBSCRIPTION(boot_profile, zmk_position_state_changed);
+
+static void boot_profile_input_callback(struct input_event *evt) {
+    if (!atomic_test_bit(&reached, BOOT_STAGE_FIRST_INPUT)) {
+        mark_stage(BOOT_STAGE_FIRST_INPUT);
+    }
+}
+
+INPUT_CALLBACK_DEFINE(NULL, boot_profile_input_callback);
+
+#if IS_ENABLED(CONFIG_SETTINGS)
+// Commit handlers run once every subtree has been loaded
+static int boot_profile_settings_commit(void) {
+    mark_stage(BOOT_STAGE_SETTINGS_LOADED);
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(boot_profile, "torabo/boot", NULL, NULL,
+                               boot_profile_settings_commit, NULL);
+#endif
+
+static int boot_profile_post_kernel(void) {
+    mark_stage(BOOT_STAGE_POST_KERNEL);
+    return 0;
+}
+
+static int boot_profile_application(void) {
+    mark_stage(BOOT_STAGE_APPLICATION);
+    return 0;
+}
+
+static int boot_profile_init_done(void) {
+    mark_stage(BOOT_STAGE_INIT_DONE);
+    return 0;
+}
+
+SYS_INIT(boot_profile_post_kernel, POST_KERNEL, 0);
+SYS_INIT(boot_profile_application, APPLICATION, 0);
+SYS_INIT(boot_profile_init_done, APPLICATION, 99);
@@ -0,0 +1,106 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <zmk/events/keycode_state_changed.h>
+#include <zmk/events/position_state_changed.h>
+
+#include "event_pool.h"
+
+LOG_MODULE_REGISTER(event_pool, CONFIG_ZMK_LOG_LEVEL);
+
+// ZMK allocates every event with k_malloc and releases it with k_free. The
+// linker wraps both (see CMakeLists.txt) so the events raised on every
+// keypress come from a fixed-block slab instead of the shared kernel heap.
+// Any other allocation, and hot events once the slab is exhausted, fall
+// through to the heap unchanged. The slab is set up by the kernel before any
+// init hook runs, so it is in place before ZMK raises its first event.
+
+#define POOL_BLOCK_SIZE                                                                            \
+    ROUND_UP(MAX(sizeof(struct zmk_position_state_changed_event),                                  \
+                 sizeof(struct zmk_keycode_state_changed_event)),                                  \
+             sizeof(void *))
+#define POOL_BLOCK_COUNT CONFIG_TORABO_EVENT_POOL_SIZE
+
+void *__real_k_malloc(size_t size);
+void __real_k_free(void *ptr);
+
+K_MEM_SLAB_DEFINE_STATIC(event_slab, POOL_BLOCK_SIZE, POOL_BLOCK_COUNT, sizeof(void *));
+
+static atomic_t pool_used = ATOMIC_INIT(0);
+static atomic_t pool_peak = ATOMIC_INIT(0);
+static atomic_t pool_fallbacks = ATOMIC_INIT(0);
+
+static bool is_hot_event_size(size_t size) {
+    return size == sizeof(struct zmk_position_state_changed_event) ||
+           size == sizeof(struct zmk_keycode_state_changed_event);
+}
+
+static bool is_pool_block(const void *ptr) {
+    return (const char *)ptr >= event_slab.buffer &&
+           (const char *)ptr < event_slab.buffer + POOL_BLOCK_SIZE * POOL_BLOCK_COUNT;
+}
+
+void *__wrap_k_malloc(size_t size) {
+    if (is_hot_event_size(size)) {
+        void *block;
+
+        if (k_mem_slab_alloc(&event_slab, &block, K_NO_WAIT) == 0) {
+            atomic_val_t used = atomic_inc(&pool_used) + 1;
+            atomic_val_t peak = atomic_get(&pool_peak);
+
+            while (used > peak && !atomic_cas(&pool_peak, peak, used)) {
+                peak = atomic_get(&pool_peak);
+            }
+            return block;
+        }
+
+        if (atomic_inc(&pool_fallbacks) == 0) {
+            LOG_WRN("Event pool exhausted (%d blocks), falling back to heap", POOL_BLOCK_COUNT);
+        }
+    }
+
+    return __real_k_malloc(size);
+}
+
+void __wrap_k_free(void *ptr) {
+    if (ptr && is_pool_block(ptr)) {
+        k_mem_slab_free(&event_slab, ptr);
+        atomic_dec(&pool_used);
+        return;
+    }
+
+    __real_k_free(ptr);
+}
+
+void event_pool_get_stats(uint32_t *used, uint32_t *peak, uint32_t *fallbacks) {
+    *used = atomic_get(&pool_used);
+    *peak = atomic_get(&pool_peak);
+    *fallbacks = atomic_get(&pool_fallbacks);
+}
+
+static void event_pool_report(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(event_pool_report_work, event_pool_report);
+
+static void event_pool_report(struct k_work *work) {
+    uint32_t used, peak, fallbacks;
+
+    event_pool_get_stats(&used, &peak, &fallbacks);
+    LOG_INF("Event pool: %d/%d blocks in use, high-water %d, heap fallbacks %d", used,
+            POOL_BLOCK_COUNT, peak, fallbacks);
+
+    k_work_schedule(&event_pool_report_work, K_SECONDS(CONFIG_TORABO_EVENT_POOL_REPORT_INTERVAL));
+}
+
+static int event_pool_init(void) {
+    if (CONFIG_TORABO_EVENT_POOL_REPORT_INTERVAL > 0) {
+        k_work_schedule(&event_pool_report_work,
+                        K_SECONDS(CONFIG_TORABO_EVENT_POOL_REPORT_INTERVAL));
+    }
+
+    return 0;
+}
+
+SYS_INIT(event_pool_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
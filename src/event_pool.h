@@ -0,0 +1,8 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+#include <stdint.h>
+
+void event_pool_get_stats(uint32_t *used, uint32_t *peak, uint32_t *fallbacks);
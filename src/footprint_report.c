@@ -0,0 +1,141 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/debug/thread_analyzer.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/sys_heap.h>
+
+#if IS_ENABLED(CONFIG_TORABO_EVENT_POOL)
+#include "event_pool.h"
+#endif
+
+LOG_MODULE_REGISTER(footprint_report, CONFIG_ZMK_LOG_LEVEL);
+
+// Measured RAM footprint of the running firmware, built in with the
+// footprint-report snippet. After the board has been used for a while the
+// stack high-water marks, heap peak and event pool peak are logged, followed
+// by a Kconfig fragment sized from them that can be appended to the role's
+// .conf. Sizes only ever grow with more use, so the longer and more varied
+// the session (typing, trackball, host and profile switches), the safer the
+// suggestion.
+
+#define REPORT_INTERVAL_S CONFIG_TORABO_FOOTPRINT_REPORT_INTERVAL
+#define MARGIN_PERCENT CONFIG_TORABO_FOOTPRINT_REPORT_MARGIN
+#define STACK_ALIGN 64
+#define MAX_THREADS 24
+
+struct stack_config {
+    const char *thread;
+    const char *symbol;
+};
+
+// Default Zephyr thread names and the options that size their stacks
+static const struct stack_config stack_configs[] = {
+    {"main", "CONFIG_MAIN_STACK_SIZE"},
+    {"sysworkq", "CONFIG_SYSTEM_WORKQUEUE_STACK_SIZE"},
+    {"idle", "CONFIG_IDLE_STACK_SIZE"},
+    {"logging", "CONFIG_LOG_PROCESS_THREAD_STACK_SIZE"},
+    {"BT RX", "CONFIG_BT_RX_STACK_SIZE"},
+    {"BT TX", "CONFIG_BT_HCI_TX_STACK_SIZE"},
+    {"BT LW WQ", "CONFIG_BT_LONG_WQ_STACK_SIZE"},
+    {"BT RX pri", "CONFIG_BT_CTLR_RX_PRIO_STACK_SIZE"},
+};
+
+struct thread_usage {
+    char name[CONFIG_THREAD_MAX_NAME_LEN];
+    size_t size;
+    size_t used;
+};
+
+static struct thread_usage threads[MAX_THREADS];
+static int thread_count;
+
+static uint32_t with_margin(uint32_t value) {
+    return value * (100 + MARGIN_PERCENT) / 100;
+}
+
+static void collect_thread(struct thread_analyzer_info *info) {
+    if (thread_count >= MAX_THREADS) {
+        return;
+    }
+
+    struct thread_usage *usage = &threads[thread_count++];
+
+    strncpy(usage->name, info->name, sizeof(usage->name) - 1);
+    usage->name[sizeof(usage->name) - 1] = '\0';
+    usage->size = info->stack_size;
+    usage->used = info->stack_used;
+}
+
+static const char *stack_symbol(const char *thread) {
+    for (int i = 0; i < ARRAY_SIZE(stack_configs); i++) {
+        if (strcmp(stack_configs[i].thread, thread) == 0) {
+            return stack_configs[i].symbol;
+        }
+    }
+
+    return NULL;
+}
+
+static void footprint_report(struct k_work *work);
+static K_WORK_DELAYABLE_DEFINE(footprint_report_work, footprint_report);
+
+static void footprint_report(struct k_work *work) {
+    thread_count = 0;
+    thread_analyzer_run(collect_thread);
+
+    LOG_INF("Footprint after %lld s (%s):", k_uptime_get() / 1000,
+            IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) ? "central" : "peripheral");
+
+    for (int i = 0; i < thread_count; i++) {
+        LOG_INF("  stack %-20s %5d / %5d bytes", threads[i].name, threads[i].used,
+                threads[i].size);
+    }
+
+#if IS_ENABLED(CONFIG_SYS_HEAP_RUNTIME_STATS) && CONFIG_HEAP_MEM_POOL_SIZE > 0
+    extern struct k_heap _system_heap;
+    struct sys_memory_stats heap_stats;
+
+    sys_heap_runtime_stats_get(&_system_heap.heap, &heap_stats);
+    LOG_INF("  heap peak %d / %d bytes", heap_stats.max_allocated_bytes,
+            CONFIG_HEAP_MEM_POOL_SIZE);
+#endif
+
+#if IS_ENABLED(CONFIG_TORABO_EVENT_POOL)
+    uint32_t used, peak, fallbacks;
+
+    event_pool_get_stats(&used, &peak, &fallbacks);
+    LOG_INF("  event pool peak %d / %d blocks, heap fallbacks %d", peak,
+            CONFIG_TORABO_EVENT_POOL_SIZE, fallbacks);
+#endif
+
+    LOG_INF("Suggested fragment (+%d%% margin):", MARGIN_PERCENT);
+
+    for (int i = 0; i < thread_count; i++) {
+        const char *symbol = stack_symbol(threads[i].name);
+
+        if (symbol) {
+            LOG_INF("%s=%d", symbol, ROUND_UP(with_margin(threads[i].used), STACK_ALIGN));
+        }
+    }
+
+#if IS_ENABLED(CONFIG_SYS_HEAP_RUNTIME_STATS) && CONFIG_HEAP_MEM_POOL_SIZE > 0
+    LOG_INF("CONFIG_HEAP_MEM_POOL_SIZE=%d",
+            ROUND_UP(with_margin(heap_stats.max_allocated_bytes), 256));
+#endif
+
+#if IS_ENABLED(CONFIG_TORABO_EVENT_POOL)
+    LOG_INF("CONFIG_TORABO_EVENT_POOL_SIZE=%d", MAX(4, with_margin(peak) + 1));
+#endif
+
+    k_work_schedule(&footprint_report_work, K_SECONDS(REPORT_INTERVAL_S));
+}
+
+static int footprint_report_init(void) {
+    k_work_schedule(&footprint_report_work, K_SECONDS(REPORT_INTERVAL_S));
+    return 0;
+}
+
+SYS_INIT(footprint_report_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,43 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+// Markers for the functions that run on every keypress and trackball report.
+// CONFIG_TORABO_HOT_PATH_RAM links them into RAM, where they run without
+// flash wait states, and CONFIG_TORABO_HOT_PATH_BENCH counts the cycles they
+// take so the two builds can be compared on the device.
+
+#include <zephyr/kernel.h>
+#include <zephyr/linker/section_tags.h>
+
+#if IS_ENABLED(CONFIG_TORABO_HOT_PATH_RAM)
+#define TORABO_HOT_PATH __ramfunc
+#else
+#define TORABO_HOT_PATH
+#endif
+
+#if IS_ENABLED(CONFIG_TORABO_HOT_PATH_BENCH)
+
+struct hot_path_bench {
+    const char *name;
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+};
+
+#define HOT_PATH_BENCH_DEFINE(_name)                                                               \
+    static struct hot_path_bench _name = {.name = #_name, .min_cycles = UINT32_MAX}
+#define HOT_PATH_BENCH_START(_name) uint32_t _name##_start = k_cycle_get_32()
+#define HOT_PATH_BENCH_END(_name) hot_path_bench_record(&_name, k_cycle_get_32() - _name##_start)
+
+void hot_path_bench_record(struct hot_path_bench *bench, uint32_t cycles);
+
+#else
+
+#define HOT_PATH_BENCH_DEFINE(_name)
+#define HOT_PATH_BENCH_START(_name)
+#define HOT_PATH_BENCH_END(_name)
+
+#endif
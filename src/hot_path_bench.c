@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+#include "hot_path.h"
+
+LOG_MODULE_REGISTER(hot_path_bench, CONFIG_ZMK_LOG_LEVEL);
+
+#define REPORT_EVERY CONFIG_TORABO_HOT_PATH_BENCH_REPORT_EVERY
+
+void hot_path_bench_record(struct hot_path_bench *bench, uint32_t cycles) {
+    bench->count++;
+    bench->total_cycles += cycles;
+    bench->min_cycles = MIN(bench->min_cycles, cycles);
+    bench->max_cycles = MAX(bench->max_cycles, cycles);
+
+    if (bench->count < REPORT_EVERY) {
+        return;
+    }
+
+    uint32_t avg_cycles = bench->total_cycles / bench->count;
+
+    LOG_INF("%s: %d calls, cycles min %d avg %d max %d (avg %d ns)", bench->name, bench->count,
+            bench->min_cycles, avg_cycles, bench->max_cycles,
+            (uint32_t)k_cyc_to_ns_floor64(avg_cycles));
+
+    bench->count = 0;
+    bench->total_cycles = 0;
+    bench->min_cycles = UINT32_MAX;
+    bench->max_cycles = 0;
+}
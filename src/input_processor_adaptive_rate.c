@@ -0,0 +1,171 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#define DT_DRV_COMPAT torabo_input_processor_adaptive_rate
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <drivers/input_processor.h>
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) || !IS_ENABLED(CONFIG_ZMK_SPLIT)
+#include <zmk/endpoints.h>
+#endif
+
+LOG_MODULE_REGISTER(input_processor_adaptive_rate, CONFIG_ZMK_LOG_LEVEL);
+
+// The sensor reports every frame it has motion, so a ball rolled slowly for
+// precise positioning produces a stream of one- and two-count reports, each
+// of which goes through the listener, the HID report and the radio. Below
+// the speed floor the deltas are summed here and sent once per low-rate
+// interval instead, which at those speeds moves the cursor by the same
+// distance with a fraction of the reports. Over USB reports cost no radio
+// time, so every frame is passed on as soon as it arrives.
+
+// A frame this many times over the floor skips the averaging and returns to
+// full rate on the spot
+#define ACCEL_FACTOR 2
+#define MAX_FRAME_GAP_MS 100
+
+struct adaptive_rate_config {
+    uint32_t speed_floor;
+    uint32_t low_rate_interval_ms;
+};
+
+struct adaptive_rate_data {
+    const struct device *sensor;
+    struct k_spinlock lock;
+    struct k_work_delayable flush_work;
+    int32_t frame_x;
+    int32_t frame_y;
+    int32_t pending_x;
+    int32_t pending_y;
+    int64_t last_frame_time;
+    int64_t next_report_time;
+    uint32_t speed;
+    bool low_rate;
+};
+
+static void update_speed(const struct adaptive_rate_config *config,
+                         struct adaptive_rate_data *data, int64_t now) {
+    uint32_t counts = abs(data->frame_x) + abs(data->frame_y);
+    int64_t gap = CLAMP(now - data->last_frame_time, 1, MAX_FRAME_GAP_MS);
+    uint32_t frame_speed = counts * 1000 / gap;
+
+    data->frame_x = 0;
+    data->frame_y = 0;
+    data->last_frame_time = now;
+    data->speed = (data->speed * 3 + frame_speed) / 4;
+
+    if (frame_speed >= config->speed_floor * ACCEL_FACTOR) {
+        data->speed = frame_speed;
+    }
+
+    bool low_rate = data->speed < config->speed_floor;
+    if (low_rate != data->low_rate) {
+        LOG_DBG("%s rate at %d counts/s", low_rate ? "Low" : "Full", data->speed);
+        data->low_rate = low_rate;
+    }
+}
+
+static bool wired(void) {
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL) || !IS_ENABLED(CONFIG_ZMK_SPLIT)
+    return zmk_endpoints_selected().transport == ZMK_TRANSPORT_USB;
+#else
+    return false;
+#endif
+}
+
+static void adaptive_rate_flush(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct adaptive_rate_data *data = CONTAINER_OF(dwork, struct adaptive_rate_data, flush_work);
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    int32_t x = data->pending_x;
+    int32_t y = data->pending_y;
+    data->pending_x = 0;
+    data->pending_y = 0;
+    k_spin_unlock(&data->lock, key);
+
+    // Goes through the processor chain again, past the report deadline, so
+    // it is passed on unchanged
+    if ((x || y) && data->sensor) {
+        input_report_rel(data->sensor, INPUT_REL_X, x, false, K_FOREVER);
+        input_report_rel(data->sensor, INPUT_REL_Y, y, true, K_FOREVER);
+    }
+}
+
+static int adaptive_rate_handle_event(const struct device *dev, struct input_event *event,
+                                      uint32_t param1, uint32_t param2,
+                                      struct zmk_input_processor_state *state) {
+    const struct adaptive_rate_config *config = dev->config;
+    struct adaptive_rate_data *data = dev->data;
+
+    if (event->type != INPUT_EV_REL ||
+        (event->code != INPUT_REL_X && event->code != INPUT_REL_Y)) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    int64_t now = k_uptime_get();
+    int32_t *frame = event->code == INPUT_REL_X ? &data->frame_x : &data->frame_y;
+    int32_t *pending = event->code == INPUT_REL_X ? &data->pending_x : &data->pending_y;
+    int ret = ZMK_INPUT_PROC_CONTINUE;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    data->sensor = event->dev;
+    *frame += event->value;
+
+    if (data->low_rate && now < data->next_report_time && !wired()) {
+        *pending += event->value;
+        ret = ZMK_INPUT_PROC_STOP;
+    } else {
+        event->value += *pending;
+        *pending = 0;
+    }
+
+    if (event->sync) {
+        if (ret == ZMK_INPUT_PROC_CONTINUE) {
+            data->next_report_time = now + config->low_rate_interval_ms;
+        }
+        update_speed(config, data, now);
+    }
+
+    bool held = data->pending_x || data->pending_y;
+    int64_t until_report = MAX(data->next_report_time - now, 0);
+
+    k_spin_unlock(&data->lock, key);
+
+    if (held && event->sync) {
+        // Send whatever is still held back if the ball stops before the
+        // next report is due
+        k_work_reschedule(&data->flush_work, K_MSEC(until_report));
+    }
+
+    return ret;
+}
+
+static int adaptive_rate_init(const struct device *dev) {
+    struct adaptive_rate_data *data = dev->data;
+
+    k_work_init_delayable(&data->flush_work, adaptive_rate_flush);
+    return 0;
+}
+
+static const struct zmk_input_processor_driver_api adaptive_rate_driver_api = {
+    .handle_event = adaptive_rate_handle_event,
+};
+
+#define ADAPTIVE_RATE_INST(n)                                                                      \
+    static struct adaptive_rate_data adaptive_rate_data_##n;                                       \
+    static const struct adaptive_rate_config adaptive_rate_config_##n = {                          \
+        .speed_floor = DT_INST_PROP(n, speed_floor),                                               \
+        .low_rate_interval_ms = DT_INST_PROP(n, low_rate_interval_ms),                             \
+    };                                                                                             \
+    DEVICE_DT_INST_DEFINE(n, adaptive_rate_init, NULL, &adaptive_rate_data_##n,                    \
+                          &adaptive_rate_config_##n, POST_KERNEL,                                  \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &adaptive_rate_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(ADAPTIVE_RATE_INST)
@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#define DT_DRV_COMPAT torabo_input_processor_fixed_transform
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <drivers/input_processor.h>
+
+#include "hot_path.h"
+
+// Every instance gets a handler of its own that calls the inline transform
+// with its devicetree flags as constants, so the compiler drops the branches
+// that do not apply and the transform costs a compare and a negate.
+
+static ALWAYS_INLINE int fixed_transform_apply(struct input_event *event, bool swap_xy,
+                                               bool invert_x, bool invert_y) {
+    if (event->type != INPUT_EV_REL ||
+        (event->code != INPUT_REL_X && event->code != INPUT_REL_Y)) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    if (swap_xy) {
+        event->code = event->code == INPUT_REL_X ? INPUT_REL_Y : INPUT_REL_X;
+    }
+
+    if ((invert_x && event->code == INPUT_REL_X) || (invert_y && event->code == INPUT_REL_Y)) {
+        event->value = -event->value;
+    }
+
+    return ZMK_INPUT_PROC_CONTINUE;
+}
+
+#define FIXED_TRANSFORM_INST(n)                                                                    \
+    static TORABO_HOT_PATH int fixed_transform_handle_event_##n(                                   \
+        const struct device *dev, struct input_event *event, uint32_t param1, uint32_t param2,    \
+        struct zmk_input_processor_state *state) {                                                 \
+        return fixed_transform_apply(event, DT_INST_PROP(n, swap_xy), DT_INST_PROP(n, invert_x),  \
+                                     DT_INST_PROP(n, invert_y));                                   \
+    }                                                                                              \
+    static const struct zmk_input_processor_driver_api fixed_transform_driver_api_##n = {          \
+        .handle_event = fixed_transform_handle_event_##n,                                          \
+    };                                                                                             \
+    DEVICE_DT_INST_DEFINE(n, NULL, NULL, NULL, NULL, POST_KERNEL,                                  \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &fixed_transform_driver_api_##n);
+
+DT_INST_FOREACH_STATUS_OKAY(FIXED_TRANSFORM_INST)
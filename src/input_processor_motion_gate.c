@@ -0,0 +1,207 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#define DT_DRV_COMPAT torabo_input_processor_motion_gate
+
+#include <stdlib.h>
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+#include <drivers/input_processor.h>
+
+#include "motion_gate.h"
+
+LOG_MODULE_REGISTER(input_processor_motion_gate, CONFIG_ZMK_LOG_LEVEL);
+
+// Dust on the ball or a lifted ball makes the sensor report small deltas
+// that wander back and forth. Passed on, they nudge the cursor and, worse,
+// count as activity that keeps the split link out of its sleep tiers.
+//
+// The PAW3222 driver does not expose the sensor's own quality registers, so
+// the gate judges the deltas themselves: motion is held back until its net
+// displacement reaches min-travel and is then passed on with the held deltas
+// added back. Held motion that keeps reversing, so that its net displacement
+// stays below half the path it travelled, is dropped once it has been held
+// for the window. Slow motion in one direction is kept across gaps until it
+// gets there, however long that takes.
+//
+// Dropped bursts are counted over a minute from the first of them, and the
+// sensor is reported dirty when there are too many.
+
+#define OPEN_HOLD_MS 100
+#define DIRTY_PERIOD_MS 60000
+
+struct motion_gate_config {
+    uint32_t min_travel;
+    uint32_t window_ms;
+    uint32_t dirty_bursts;
+};
+
+struct motion_gate_data {
+    const struct device *dev;
+    struct k_spinlock lock;
+    int32_t pending_x;
+    int32_t pending_y;
+    uint32_t path;
+    int64_t burst_start;
+    int64_t last_event_time;
+    bool open;
+    uint32_t dropped_bursts;
+    bool dirty;
+    struct k_work_delayable dirty_work;
+    // Input device whose motion this instance gates, and when it last let
+    // some of it through
+    const struct device *source;
+    atomic_t last_open_time;
+};
+
+static uint32_t net_travel(const struct motion_gate_data *data) {
+    return abs(data->pending_x) + abs(data->pending_y);
+}
+
+static bool wanders(const struct motion_gate_data *data) {
+    return net_travel(data) * 2 < data->path;
+}
+
+static void start_burst(struct motion_gate_data *data, int64_t now) {
+    data->pending_x = 0;
+    data->pending_y = 0;
+    data->path = 0;
+    data->burst_start = now;
+}
+
+static void drop_burst(struct motion_gate_data *data, int64_t now) {
+    LOG_DBG("Dropped motion burst of %d, %d over a path of %d", data->pending_x, data->pending_y,
+            data->path);
+
+    start_burst(data, now);
+    data->dropped_bursts++;
+
+    // Starts the minute on the first drop, and leaves a running one alone
+    k_work_schedule(&data->dirty_work, K_MSEC(DIRTY_PERIOD_MS));
+}
+
+static void motion_gate_dirty_check(struct k_work *work) {
+    struct k_work_delayable *dwork = k_work_delayable_from_work(work);
+    struct motion_gate_data *data = CONTAINER_OF(dwork, struct motion_gate_data, dirty_work);
+    const struct motion_gate_config *config = data->dev->config;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+    uint32_t dropped = data->dropped_bursts;
+    data->dropped_bursts = 0;
+    k_spin_unlock(&data->lock, key);
+
+    bool dirty = dropped >= config->dirty_bursts;
+    if (dirty && !data->dirty) {
+        LOG_WRN("Trackball sensor looks dirty (%d spurious bursts in the last minute), "
+                "please clean the ball and the sensor window",
+                dropped);
+    } else if (!dirty && data->dirty) {
+        LOG_INF("Trackball sensor is clean again");
+    }
+    data->dirty = dirty;
+
+    // Keep counting while dirty, so that cleaning it is noticed
+    if (dirty) {
+        k_work_schedule(&data->dirty_work, K_MSEC(DIRTY_PERIOD_MS));
+    }
+}
+
+static int motion_gate_handle_event(const struct device *dev, struct input_event *event,
+                                    uint32_t param1, uint32_t param2,
+                                    struct zmk_input_processor_state *state) {
+    const struct motion_gate_config *config = dev->config;
+    struct motion_gate_data *data = dev->data;
+
+    if (event->type != INPUT_EV_REL ||
+        (event->code != INPUT_REL_X && event->code != INPUT_REL_Y)) {
+        return ZMK_INPUT_PROC_CONTINUE;
+    }
+
+    int64_t now = k_uptime_get();
+    int32_t *pending = event->code == INPUT_REL_X ? &data->pending_x : &data->pending_y;
+    int ret = ZMK_INPUT_PROC_STOP;
+
+    k_spinlock_key_t key = k_spin_lock(&data->lock);
+
+    data->source = event->dev;
+
+    // A gap closes an open burst. Held motion that wandered is dropped, held
+    // motion in one direction carries over.
+    if (now - data->last_event_time > config->window_ms) {
+        if (data->open) {
+            data->open = false;
+            start_burst(data, now);
+        } else if (wanders(data)) {
+            drop_burst(data, now);
+        }
+    }
+    data->last_event_time = now;
+
+    *pending += event->value;
+    data->path += abs(event->value);
+
+    if (!data->open && net_travel(data) >= config->min_travel && !wanders(data)) {
+        data->open = true;
+    }
+
+    if (data->open) {
+        event->value = *pending;
+        *pending = 0;
+        ret = ZMK_INPUT_PROC_CONTINUE;
+    } else if (now - data->burst_start > config->window_ms && wanders(data)) {
+        // Moving all window long without getting anywhere
+        drop_burst(data, now);
+    }
+
+    k_spin_unlock(&data->lock, key);
+
+    if (ret == ZMK_INPUT_PROC_CONTINUE) {
+        atomic_set(&data->last_open_time, k_uptime_get_32());
+    }
+
+    return ret;
+}
+
+static int motion_gate_init(const struct device *dev) {
+    struct motion_gate_data *data = dev->data;
+
+    data->dev = dev;
+    k_work_init_delayable(&data->dirty_work, motion_gate_dirty_check);
+    return 0;
+}
+
+static const struct zmk_input_processor_driver_api motion_gate_driver_api = {
+    .handle_event = motion_gate_handle_event,
+};
+
+#define MOTION_GATE_INST(n)                                                                        \
+    static struct motion_gate_data motion_gate_data_##n;                                           \
+    static const struct motion_gate_config motion_gate_config_##n = {                              \
+        .min_travel = DT_INST_PROP(n, min_travel),                                                 \
+        .window_ms = DT_INST_PROP(n, window_ms),                                                   \
+        .dirty_bursts = DT_INST_PROP(n, dirty_bursts_per_minute),                                  \
+    };                                                                                             \
+    DEVICE_DT_INST_DEFINE(n, motion_gate_init, NULL, &motion_gate_data_##n,                        \
+                          &motion_gate_config_##n, POST_KERNEL,                                    \
+                          CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &motion_gate_driver_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MOTION_GATE_INST)
+
+#define MOTION_GATE_DATA(n) &motion_gate_data_##n,
+
+static struct motion_gate_data *const gates[] = {DT_INST_FOREACH_STATUS_OKAY(MOTION_GATE_DATA)};
+
+bool motion_gate_is_open(const struct device *source) {
+    for (int i = 0; i < ARRAY_SIZE(gates); i++) {
+        if (gates[i]->source == source) {
+            return k_uptime_get_32() - (uint32_t)atomic_get(&gates[i]->last_open_time) <=
+                   OPEN_HOLD_MS;
+        }
+    }
+
+    // Not behind a gate, or no motion from it has reached one yet
+    return true;
+}
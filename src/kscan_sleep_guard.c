@@ -0,0 +1,264 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+
+LOG_MODULE_REGISTER(kscan_sleep_guard, CONFIG_ZMK_LOG_LEVEL);
+
+// While waiting for a keypress the matrix drives every row and pulls every
+// column down, so a key held down by something resting on the board draws
+// current through its column's pull-down all night, and in system off its
+// column SENSE fires at once and wakes the board straight back up.
+//
+// When the board goes idle with a key held, the matrix driver is suspended
+// and the pins are taken over here: columns that read active are disconnected
+// without pull and left out of the wake set, the others wake on a level
+// interrupt as usual. Disconnected columns are sampled once per poll interval
+// and re-armed as soon as their key is released. Once the last one is, the
+// matrix goes back to the kscan driver, whose first scan reports the release.
+// The same setup is applied before system off, where only the clean columns
+// can wake the board.
+
+#define KSCAN_NODE DT_CHOSEN(zmk_kscan)
+#define POLL_INTERVAL_MS CONFIG_TORABO_KSCAN_SLEEP_GUARD_POLL_MS
+#define SETTLE_US 5
+
+BUILD_ASSERT(DT_NODE_HAS_COMPAT(KSCAN_NODE, zmk_kscan_gpio_matrix),
+             "kscan sleep guard needs a zmk,kscan-gpio-matrix kscan");
+
+static const struct device *const kscan = DEVICE_DT_GET(KSCAN_NODE);
+static const struct gpio_dt_spec rows[] = {
+    DT_FOREACH_PROP_ELEM_SEP(KSCAN_NODE, row_gpios, GPIO_DT_SPEC_GET_BY_IDX, (, ))};
+static const struct gpio_dt_spec cols[] = {
+    DT_FOREACH_PROP_ELEM_SEP(KSCAN_NODE, col_gpios, GPIO_DT_SPEC_GET_BY_IDX, (, ))};
+
+static struct gpio_callback col_callbacks[ARRAY_SIZE(cols)];
+static uint32_t dropped_cols = 0;
+static bool guarding = false;
+
+static void release_guard(struct k_work *work);
+static void poll_dropped_cols(struct k_work *work);
+static K_WORK_DEFINE(release_work, release_guard);
+static K_WORK_DELAYABLE_DEFINE(poll_work, poll_dropped_cols);
+
+static void disconnect_col(int i) {
+    gpio_pin_interrupt_configure_dt(&cols[i], GPIO_INT_DISABLE);
+    // Not gpio_pin_configure_dt(): that would keep the pull-down from the
+    // devicetree flags, and the pull is the current path
+    gpio_pin_configure(cols[i].port, cols[i].pin, GPIO_DISCONNECTED);
+}
+
+static bool col_is_active(int i) {
+    gpio_pin_configure_dt(&cols[i], GPIO_INPUT);
+    k_busy_wait(SETTLE_US);
+    return gpio_pin_get_dt(&cols[i]) > 0;
+}
+
+static void arm_col(int i) {
+    gpio_pin_interrupt_configure_dt(&cols[i], GPIO_INT_LEVEL_ACTIVE);
+}
+
+// Takes the matrix over from the suspended kscan driver. Returns the mask of
+// columns left out of the wake set.
+static uint32_t arm_guard(void) {
+    uint32_t dropped = 0;
+
+    for (int i = 0; i < ARRAY_SIZE(rows); i++) {
+        gpio_pin_configure_dt(&rows[i], GPIO_OUTPUT_ACTIVE);
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        if (col_is_active(i)) {
+            disconnect_col(i);
+            dropped |= BIT(i);
+        } else {
+            arm_col(i);
+        }
+    }
+
+    return dropped;
+}
+
+static void poll_dropped_cols(struct k_work *work) {
+    if (!guarding) {
+        return;
+    }
+
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        if (!(dropped_cols & BIT(i))) {
+            continue;
+        }
+
+        if (col_is_active(i)) {
+            disconnect_col(i);
+        } else {
+            LOG_DBG("Column %d released, re-arming it", i);
+            dropped_cols &= ~BIT(i);
+            arm_col(i);
+        }
+    }
+
+    if (dropped_cols) {
+        k_work_schedule(&poll_work, K_MSEC(POLL_INTERVAL_MS));
+    } else {
+        // The kscan driver still has the keys down, so hand the matrix back
+        // for it to see the release
+        release_guard(NULL);
+    }
+}
+
+// A press on an armed column hands the matrix back to the kscan driver,
+// which reinitializes its pins on resume and picks up the press
+static void release_guard(struct k_work *work) {
+    if (!guarding) {
+        return;
+    }
+
+    guarding = false;
+    k_work_cancel_delayable(&poll_work);
+
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        gpio_pin_interrupt_configure_dt(&cols[i], GPIO_INT_DISABLE);
+    }
+
+    int err = pm_device_action_run(kscan, PM_DEVICE_ACTION_RESUME);
+    if (err && err != -EALREADY) {
+        LOG_ERR("Failed to resume kscan: %d", err);
+    }
+}
+
+// The wake press holds its column active, so the level interrupts are turned
+// off here as in the kscan driver, or they would keep firing until the work
+// item gets to run
+static void col_irq_handler(const struct device *port, struct gpio_callback *cb,
+                            gpio_port_pins_t pins) {
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        gpio_pin_interrupt_configure_dt(&cols[i], GPIO_INT_DISABLE);
+    }
+
+    k_work_submit(&release_work);
+}
+
+// Checks for held keys without disturbing the kscan driver: rows are only
+// driven, not reconfigured, and the driver's next scan sets them again if
+// it is polling. Runs on the system work queue, like the driver's scan, so
+// the two never interleave.
+static bool any_key_held(void) {
+    bool held = false;
+
+    for (int i = 0; i < ARRAY_SIZE(rows); i++) {
+        gpio_pin_set_dt(&rows[i], 1);
+    }
+    k_busy_wait(SETTLE_US);
+
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        if (gpio_pin_get_dt(&cols[i]) > 0) {
+            held = true;
+        }
+    }
+
+    return held;
+}
+
+static int enter_guard(void) {
+    int err = pm_device_action_run(kscan, PM_DEVICE_ACTION_SUSPEND);
+    if (err && err != -EALREADY) {
+        return err;
+    }
+
+    guarding = true;
+    dropped_cols = arm_guard();
+    return 0;
+}
+
+static int kscan_sleep_guard_activity_listener(const zmk_event_t *eh) {
+    const struct zmk_activity_state_changed *ev = as_zmk_activity_state_changed(eh);
+    int err;
+
+    switch (ev->state) {
+    case ZMK_ACTIVITY_IDLE:
+        // With nothing held the kscan driver's own idle setup is already
+        // optimal, so leave it alone
+        if (guarding || !any_key_held()) {
+            break;
+        }
+
+        err = enter_guard();
+        if (err) {
+            LOG_WRN("Failed to suspend kscan: %d", err);
+            break;
+        }
+
+        if (dropped_cols) {
+            LOG_INF("Keys held while idle, columns 0x%02x left out of the wake set",
+                    dropped_cols);
+            k_work_schedule(&poll_work, K_MSEC(POLL_INTERVAL_MS));
+        } else {
+            // Released in the meantime
+            release_guard(NULL);
+        }
+        break;
+    case ZMK_ACTIVITY_ACTIVE:
+        release_guard(NULL);
+        break;
+    default:
+        break;
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(kscan_sleep_guard, kscan_sleep_guard_activity_listener);
+ZMK_SUBSCRIPTION(kscan_sleep_guard, zmk_activity_state_changed);
+
+// The kscan is a wakeup source and is not suspended before system off, but
+// this device is, which gives it the last word on the matrix pins
+static int kscan_sleep_guard_pm_action(const struct device *dev, enum pm_device_action action) {
+    int err;
+
+    switch (action) {
+    case PM_DEVICE_ACTION_SUSPEND:
+        k_work_cancel_delayable(&poll_work);
+
+        if (guarding) {
+            dropped_cols = arm_guard();
+            return 0;
+        }
+
+        err = enter_guard();
+        if (err == 0 && dropped_cols) {
+            LOG_INF("Columns 0x%02x held at system off, left out of the wake set",
+                    dropped_cols);
+        }
+        return err;
+    case PM_DEVICE_ACTION_RESUME:
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int kscan_sleep_guard_init(const struct device *dev) {
+    for (int i = 0; i < ARRAY_SIZE(cols); i++) {
+        gpio_init_callback(&col_callbacks[i], col_irq_handler, BIT(cols[i].pin));
+
+        int err = gpio_add_callback_dt(&cols[i], &col_callbacks[i]);
+        if (err) {
+            LOG_ERR("Failed to add column %d callback: %d", i, err);
+            return err;
+        }
+    }
+
+    return 0;
+}
+
+PM_DEVICE_DEFINE(kscan_sleep_guard, kscan_sleep_guard_pm_action);
+DEVICE_DEFINE(kscan_sleep_guard, "kscan_sleep_guard", kscan_sleep_guard_init,
+              PM_DEVICE_GET(kscan_sleep_guard), NULL, NULL, POST_KERNEL,
+              CONFIG_APPLICATION_INIT_PRIORITY, NULL);
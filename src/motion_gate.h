@@ -0,0 +1,17 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+#include <stdbool.h>
+#include <zephyr/device.h>
+#include <zephyr/sys/util_macro.h>
+
+// True while the motion gate that sees the motion of source passes it on,
+// false while it is holding back or dropping it. Motion of a device that no
+// gate sees always counts.
+#if IS_ENABLED(CONFIG_TORABO_INPUT_PROCESSOR_MOTION_GATE)
+bool motion_gate_is_open(const struct device *source);
+#else
+static inline bool motion_gate_is_open(const struct device *source) { return true; }
+#endif
@@ -0,0 +1,108 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#define DT_DRV_COMPAT torabo_motion_wakeup
+
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/drivers/hwinfo.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+
+LOG_MODULE_REGISTER(motion_wakeup, CONFIG_ZMK_LOG_LEVEL);
+
+// ZMK suspends every device that is not a wakeup source before system off.
+// This device initializes before the sensor driver, so it is suspended after
+// it and gets the last word on the motion and power lines.
+
+struct motion_wakeup_config {
+    const struct device *sensor;
+    struct gpio_dt_spec motion;
+    struct gpio_dt_spec power;
+};
+
+static int motion_wakeup_pm_action(const struct device *dev, enum pm_device_action action) {
+    const struct motion_wakeup_config *config = dev->config;
+    int err;
+
+    switch (action) {
+    case PM_DEVICE_ACTION_SUSPEND:
+        // A sensor that failed its init may hold the line anywhere, and an
+        // asserted line would wake the board straight out of system off
+        if (!device_is_ready(config->sensor)) {
+            LOG_WRN("Trackball sensor not ready, not arming motion wakeup");
+            return 0;
+        }
+
+        // Keep the sensor powered. Left alone it drops to its deepest sleep
+        // mode and still pulls the motion line on movement.
+        if (config->power.port) {
+            err = gpio_pin_configure_dt(&config->power, GPIO_OUTPUT_ACTIVE);
+            if (err) {
+                return err;
+            }
+        }
+
+        // The pull-up keeps the active-low line deasserted while the sensor
+        // is not driving it
+        err = gpio_pin_configure_dt(&config->motion, GPIO_INPUT | GPIO_PULL_UP);
+        if (err) {
+            return err;
+        }
+
+        if (gpio_pin_get_dt(&config->motion) > 0) {
+            LOG_DBG("Motion pending at suspend, system off will wake at once");
+        }
+
+        // Level interrupts map to pin SENSE on nRF, which wakes system off
+        return gpio_pin_interrupt_configure_dt(&config->motion, GPIO_INT_LEVEL_ACTIVE);
+    case PM_DEVICE_ACTION_RESUME:
+        // Waking from system off is a reset, and the sensor driver sets the
+        // lines up again during init
+        return 0;
+    default:
+        return -ENOTSUP;
+    }
+}
+
+static int motion_wakeup_init(const struct device *dev) {
+    const struct motion_wakeup_config *config = dev->config;
+
+    if (!gpio_is_ready_dt(&config->motion)) {
+        LOG_ERR("Motion GPIO not ready");
+        return -ENODEV;
+    }
+
+    int err = gpio_pin_configure_dt(&config->motion, GPIO_INPUT | GPIO_PULL_UP);
+    if (err) {
+        return err;
+    }
+
+#if IS_ENABLED(CONFIG_HWINFO)
+    uint32_t cause;
+
+    // The motion that woke the board is still latched in the sensor, so the
+    // line stays asserted until the driver reads it after its own init.
+    // Whether those counts reach the pointer is up to the driver, so the
+    // wake is only logged here.
+    if (hwinfo_get_reset_cause(&cause) == 0 && (cause & RESET_LOW_POWER_WAKE) &&
+        gpio_pin_get_dt(&config->motion) > 0) {
+        LOG_INF("Woken from system off by trackball motion");
+    }
+#endif
+
+    return 0;
+}
+
+#define MOTION_WAKEUP_INST(n)                                                                      \
+    static const struct motion_wakeup_config motion_wakeup_config_##n = {                          \
+        .sensor = DEVICE_DT_GET(DT_INST_PHANDLE(n, sensor)),                                       \
+        .motion = GPIO_DT_SPEC_GET(DT_INST_PHANDLE(n, sensor), irq_gpios),                         \
+        .power = GPIO_DT_SPEC_GET_OR(DT_INST_PHANDLE(n, sensor), power_gpios, {0}),                \
+    };                                                                                             \
+    PM_DEVICE_DT_INST_DEFINE(n, motion_wakeup_pm_action);                                          \
+    DEVICE_DT_INST_DEFINE(n, motion_wakeup_init, PM_DEVICE_DT_INST_GET(n), NULL,                   \
+                          &motion_wakeup_config_##n, POST_KERNEL,                                  \
+                          CONFIG_TORABO_MOTION_WAKEUP_INIT_PRIORITY, NULL);
+
+DT_INST_FOREACH_STATUS_OKAY(MOTION_WAKEUP_INST)
@@ -0,0 +1,241 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/settings/settings.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/activity_state_changed.h>
+#include <zmk/events/battery_state_changed.h>
+
+#include "power_policy.h"
+#include "split_power_mgmt.h"
+
+LOG_MODULE_REGISTER(power_governor, CONFIG_ZMK_LOG_LEVEL);
+
+// Closed-loop tuning of the split link tiers. Once per window the battery
+// drain of both halves is compared with the budget that meets the target
+// runtime, and the governor level moves one step towards it. The level scales
+// the tier policy with power_policy_scale(), so tools/power_sim --level shows
+// what each level does to a recorded trace.
+//
+// Battery levels come from non_lipo_battery through zmk_battery_state_changed
+// and, from the peripheral, zmk_peripheral_battery_state_changed. The board
+// draws next to nothing in system off and is reset on every wake from it, so
+// drain is measured per hour of uptime and compared with a budget per hour of
+// the expected daily uptime. Uptime is taken from the tier residency and
+// added to the window in settings every few minutes and before system off,
+// so short sessions count as well.
+
+#define ACCOUNT_SECONDS 600
+#define MS_PER_HOUR 3600000LL
+#define WINDOW_MS (CONFIG_TORABO_POWER_GOVERNOR_WINDOW_HOURS * MS_PER_HOUR)
+// Ten-thousandths of a percent per hour of uptime that empty the battery in
+// the target time
+#define DRAIN_BUDGET                                                                               \
+    (1000000 / (CONFIG_TORABO_POWER_GOVERNOR_TARGET_DAYS *                                         \
+                CONFIG_TORABO_POWER_GOVERNOR_DAILY_UPTIME_HOURS))
+// Tightening the tiers only saves power while the link waits in the shallow
+// tiers. Below this share of the window it spends there, the drain comes
+// from elsewhere and a lower level would only cost latency.
+#define SHALLOW_MIN_PERCENT 10
+// A rise this large means fresh batteries were put in
+#define BATTERY_REPLACED_RISE 10
+#define SOC_UNKNOWN 0xff
+
+enum battery_source {
+    BATTERY_CENTRAL,
+    BATTERY_PERIPHERAL,
+    BATTERY_COUNT,
+};
+
+struct governor_state {
+    int8_t level;
+    uint8_t window_start_soc[BATTERY_COUNT];
+    uint32_t window_ms;
+    uint32_t shallow_ms;
+};
+
+static struct governor_state state = {
+    .level = 0,
+    .window_start_soc = {SOC_UNKNOWN, SOC_UNKNOWN},
+    .window_ms = 0,
+    .shallow_ms = 0,
+};
+static uint8_t current_soc[BATTERY_COUNT] = {SOC_UNKNOWN, SOC_UNKNOWN};
+static int64_t accounted_residency[POWER_MODE_COUNT];
+static const struct power_policy base_policy = POWER_POLICY_DEFAULT;
+static struct k_work_delayable governor_work;
+
+static void save_state(void) {
+    int err = settings_save_one("torabo/gov/state", &state, sizeof(state));
+    if (err) {
+        LOG_WRN("Failed to save governor state: %d", err);
+    }
+}
+
+static void apply_level(void) {
+    struct power_policy policy;
+
+    power_policy_scale(&policy, &base_policy, state.level);
+    split_power_mgmt_set_policy(&policy);
+
+    LOG_INF("Governor level %d: timeouts %d/%d/%d ms, interval x%d/x%d/x%d", state.level,
+            policy.sleep_timeout_ms[0], policy.sleep_timeout_ms[1], policy.sleep_timeout_ms[2],
+            policy.interval_mult[POWER_MODE_SLEEP1], policy.interval_mult[POWER_MODE_SLEEP2],
+            policy.interval_mult[POWER_MODE_SLEEP3]);
+}
+
+static void restart_window(void) {
+    state.window_ms = 0;
+    state.shallow_ms = 0;
+    memcpy(state.window_start_soc, current_soc, sizeof(current_soc));
+}
+
+// Adds the uptime since the last call to the window, split by tier
+static void account_uptime(void) {
+    int64_t residency[POWER_MODE_COUNT];
+
+    split_power_mgmt_get_residency(residency);
+
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        uint32_t delta = residency[mode] - accounted_residency[mode];
+
+        state.window_ms += delta;
+        if (mode != POWER_MODE_SLEEP3) {
+            state.shallow_ms += delta;
+        }
+        accounted_residency[mode] = residency[mode];
+    }
+}
+
+static void evaluate_window(void) {
+    int32_t drain = -1;
+
+    // Tune for whichever half runs down faster
+    for (int i = 0; i < BATTERY_COUNT; i++) {
+        if (state.window_start_soc[i] == SOC_UNKNOWN || current_soc[i] == SOC_UNKNOWN ||
+            current_soc[i] > state.window_start_soc[i]) {
+            continue;
+        }
+
+        int32_t side_drain = (state.window_start_soc[i] - current_soc[i]) * 10000LL *
+                             MS_PER_HOUR / state.window_ms;
+        drain = MAX(drain, side_drain);
+    }
+
+    uint32_t shallow_percent = (uint64_t)state.shallow_ms * 100 / state.window_ms;
+
+    LOG_INF("Governor window: %d min uptime, drain %d/10000 %%/h, budget %d, "
+            "%d%% outside sleep3",
+            state.window_ms / 60000, drain, DRAIN_BUDGET, shallow_percent);
+
+    if (drain >= 0) {
+        int level = power_policy_next_level(state.level, drain, DRAIN_BUDGET);
+
+        if (level < state.level && shallow_percent < SHALLOW_MIN_PERCENT) {
+            LOG_INF("Over budget with the link already in sleep3, keeping level %d",
+                    state.level);
+            level = state.level;
+        }
+
+        if (level != state.level) {
+            state.level = level;
+            apply_level();
+        }
+    }
+
+    restart_window();
+}
+
+static void governor_tick(struct k_work *work) {
+    account_uptime();
+
+    if (state.window_ms >= WINDOW_MS) {
+        evaluate_window();
+    }
+
+    save_state();
+    k_work_schedule(&governor_work, K_SECONDS(ACCOUNT_SECONDS));
+}
+
+static void update_soc(enum battery_source source, uint8_t soc) {
+    uint8_t start = state.window_start_soc[source];
+
+    current_soc[source] = soc;
+
+    if (start == SOC_UNKNOWN) {
+        state.window_start_soc[source] = soc;
+    } else if (soc >= start + BATTERY_REPLACED_RISE) {
+        LOG_INF("Fresh batteries detected, resetting the governor");
+        state.level = 0;
+        restart_window();
+        apply_level();
+        save_state();
+    }
+}
+
+static int power_governor_listener(const zmk_event_t *eh) {
+    const struct zmk_battery_state_changed *ev = as_zmk_battery_state_changed(eh);
+    if (ev) {
+        update_soc(BATTERY_CENTRAL, ev->state_of_charge);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_peripheral_battery_state_changed *pev =
+        as_zmk_peripheral_battery_state_changed(eh);
+    if (pev && pev->source == 0) {
+        update_soc(BATTERY_PERIPHERAL, pev->state_of_charge);
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    // Keep the uptime of this session before system off
+    const struct zmk_activity_state_changed *aev = as_zmk_activity_state_changed(eh);
+    if (aev && aev->state == ZMK_ACTIVITY_SLEEP) {
+        account_uptime();
+        save_state();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(power_governor, power_governor_listener);
+ZMK_SUBSCRIPTION(power_governor, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION(power_governor, zmk_peripheral_battery_state_changed);
+ZMK_SUBSCRIPTION(power_governor, zmk_activity_state_changed);
+
+static int governor_settings_set(const char *name, size_t len, settings_read_cb read_cb,
+                                 void *cb_arg) {
+    if (strcmp(name, "state") != 0) {
+        return -ENOENT;
+    }
+
+    if (len != sizeof(state)) {
+        return -EINVAL;
+    }
+
+    int err = read_cb(cb_arg, &state, sizeof(state));
+    if (err < 0) {
+        return err;
+    }
+
+    state.level = CLAMP(state.level, POWER_POLICY_LEVEL_MIN, POWER_POLICY_LEVEL_MAX);
+    return 0;
+}
+
+static int governor_settings_commit(void) {
+    apply_level();
+    return 0;
+}
+
+SETTINGS_STATIC_HANDLER_DEFINE(power_governor, "torabo/gov", NULL, governor_settings_set,
+                               governor_settings_commit, NULL);
+
+static int power_governor_init(void) {
+    k_work_init_delayable(&governor_work, governor_tick);
+    k_work_schedule(&governor_work, K_SECONDS(ACCOUNT_SECONDS));
+    return 0;
+}
+
+SYS_INIT(power_governor_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
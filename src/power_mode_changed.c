@@ -0,0 +1,6 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include "power_mode_changed.h"
+
+ZMK_EVENT_IMPL(torabo_power_mode_changed);
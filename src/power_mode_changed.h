@@ -0,0 +1,16 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+#include <zmk/event_manager.h>
+
+#include "power_policy.h"
+
+// Raised by the split power management on the central when the split link
+// moves to another tier
+struct torabo_power_mode_changed {
+    enum power_mode mode;
+};
+
+ZMK_EVENT_DECLARE(torabo_power_mode_changed);
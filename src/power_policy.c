@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include "power_policy.h"
+
+const char *power_mode_name(enum power_mode mode) {
+    switch (mode) {
+    case POWER_MODE_ACTIVE:
+        return "active";
+    case POWER_MODE_SLEEP1:
+        return "sleep1";
+    case POWER_MODE_SLEEP2:
+        return "sleep2";
+    case POWER_MODE_SLEEP3:
+        return "sleep3";
+    default:
+        return "unknown";
+    }
+}
+
+enum power_mode power_policy_target_mode(const struct power_policy *policy, int64_t idle_time) {
+    // Determine target mode based on idle time
+    for (int mode = POWER_MODE_SLEEP3; mode > POWER_MODE_ACTIVE; mode--) {
+        if (idle_time >= policy->sleep_timeout_ms[mode - 1]) {
+            return mode;
+        }
+    }
+
+    return POWER_MODE_ACTIVE;
+}
+
+int32_t power_policy_next_timeout(const struct power_policy *policy, enum power_mode mode,
+                                  int64_t idle_time) {
+    if (mode >= POWER_MODE_SLEEP3) {
+        return -1; // No further transitions from SLEEP3
+    }
+
+    return policy->sleep_timeout_ms[mode] - idle_time;
+}
+
+void power_policy_conn_param(const struct power_policy *policy, enum power_mode mode,
+                             uint16_t active_interval, uint16_t active_latency,
+                             uint16_t *interval, uint16_t *latency) {
+    uint8_t mult = policy->interval_mult[mode];
+
+    *interval = active_interval * mult;
+    *latency = (active_latency + mult - 1) / mult;
+}
+
+void power_policy_scale(struct power_policy *policy, const struct power_policy *base, int level) {
+    *policy = *base;
+
+    for (int i = 0; i < POWER_MODE_COUNT - 1; i++) {
+        int32_t timeout = level >= 0 ? base->sleep_timeout_ms[i] << level
+                                     : base->sleep_timeout_ms[i] >> -level;
+
+        policy->sleep_timeout_ms[i] =
+            timeout < POWER_POLICY_MIN_TIMEOUT_MS ? POWER_POLICY_MIN_TIMEOUT_MS : timeout;
+    }
+
+    if (level >= 0) {
+        return;
+    }
+
+    for (int mode = POWER_MODE_SLEEP1; mode < POWER_MODE_COUNT; mode++) {
+        int mult = base->interval_mult[mode] << -level;
+
+        policy->interval_mult[mode] =
+            mult > POWER_POLICY_MAX_INTERVAL_MULT ? POWER_POLICY_MAX_INTERVAL_MULT : mult;
+    }
+}
+
+int power_policy_next_level(int level, int32_t drain, int32_t budget) {
+    // A dead band of +-25% around the budget keeps the level from oscillating
+    // on the 1% resolution of the battery level
+    if (drain * 4 > budget * 5 && level > POWER_POLICY_LEVEL_MIN) {
+        return level - 1;
+    }
+    if (drain * 4 < budget * 3 && level < POWER_POLICY_LEVEL_MAX) {
+        return level + 1;
+    }
+
+    return level;
+}
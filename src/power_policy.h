@@ -0,0 +1,66 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+// Tier decisions of the split power management, kept free of Zephyr APIs so
+// the same code runs in the firmware and in tools/power_sim.
+
+#include <stdint.h>
+
+#define SLEEP1_TIMEOUT_MS 5000   // 5 seconds to sleep1 from active
+#define SLEEP2_TIMEOUT_MS 15000  // 15 seconds to sleep2 from sleep1
+#define SLEEP3_TIMEOUT_MS 30000  // 30 seconds to sleep3 from sleep2
+
+enum power_mode {
+    POWER_MODE_ACTIVE,
+    POWER_MODE_SLEEP1,
+    POWER_MODE_SLEEP2,
+    POWER_MODE_SLEEP3,
+    POWER_MODE_COUNT,
+};
+
+struct power_policy {
+    // Idle time after which SLEEP1, SLEEP2 and SLEEP3 are entered
+    int32_t sleep_timeout_ms[POWER_MODE_COUNT - 1];
+    // Connection interval of each mode as a multiple of the active interval
+    uint8_t interval_mult[POWER_MODE_COUNT];
+};
+
+// Governor levels: 0 is the default policy, positive levels stay responsive
+// longer, negative levels sleep sooner and at longer intervals
+#define POWER_POLICY_LEVEL_MIN -3
+#define POWER_POLICY_LEVEL_MAX 3
+#define POWER_POLICY_MIN_TIMEOUT_MS 1000
+#define POWER_POLICY_MAX_INTERVAL_MULT 16
+
+#define POWER_POLICY_DEFAULT                                                                       \
+    {                                                                                              \
+        .sleep_timeout_ms = {SLEEP1_TIMEOUT_MS, SLEEP2_TIMEOUT_MS, SLEEP3_TIMEOUT_MS},             \
+        .interval_mult = {1, 2, 4, 8},                                                             \
+    }
+
+const char *power_mode_name(enum power_mode mode);
+
+// Mode the link should be in after idle_time ms without activity
+enum power_mode power_policy_target_mode(const struct power_policy *policy, int64_t idle_time);
+
+// Time until the mode after `mode` is due, or -1 when `mode` is the last one
+int32_t power_policy_next_timeout(const struct power_policy *policy, enum power_mode mode,
+                                  int64_t idle_time);
+
+// Interval and peripheral latency of `mode`. The latency shrinks with the
+// interval so the time the peripheral may stay silent stays roughly the same.
+void power_policy_conn_param(const struct power_policy *policy, enum power_mode mode,
+                             uint16_t active_interval, uint16_t active_latency,
+                             uint16_t *interval, uint16_t *latency);
+
+// Derive the policy of a governor level from a base policy: timeouts double
+// per level up and halve per level down, and below level 0 the sleep tiers'
+// interval multipliers double per level as well.
+void power_policy_scale(struct power_policy *policy, const struct power_policy *base, int level);
+
+// Next governor level for a measured battery drain and the drain budget that
+// meets the target runtime, both in ten-thousandths of a percent per hour of
+// uptime
+int power_policy_next_level(int level, int32_t drain, int32_t budget);
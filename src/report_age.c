@@ -0,0 +1,81 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/atomic.h>
+
+LOG_MODULE_REGISTER(report_age, CONFIG_ZMK_LOG_LEVEL);
+
+// How old trackball motion is by the time it reaches the input listeners:
+// from the motion interrupt that announced it, through the sensor driver's
+// deferred SPI read, to the input event that carries the deltas. Whatever
+// the processors and the report path add comes on top of this.
+
+#define TRACKBALL_NODE DT_NODELABEL(trackball)
+#define REPORT_EVERY CONFIG_TORABO_REPORT_AGE_REPORT_EVERY
+
+static const struct gpio_dt_spec motion = GPIO_DT_SPEC_GET(TRACKBALL_NODE, irq_gpios);
+static struct gpio_callback motion_cb;
+
+// Cycle count of the first motion interrupt not yet followed by an event,
+// 0 when there is none
+static atomic_t irq_cycles = ATOMIC_INIT(0);
+
+static uint32_t sample_count = 0;
+static uint32_t min_us = UINT32_MAX;
+static uint32_t max_us = 0;
+static uint64_t total_us = 0;
+
+static void motion_irq_handler(const struct device *port, struct gpio_callback *cb,
+                               gpio_port_pins_t pins) {
+    // The low bit is forced so a real timestamp never reads as 0
+    atomic_cas(&irq_cycles, 0, (atomic_val_t)k_cycle_get_32() | 1);
+}
+
+static void report_age_input_callback(struct input_event *evt) {
+    if (!evt->sync) {
+        return;
+    }
+
+    uint32_t start = atomic_set(&irq_cycles, 0);
+    if (start == 0) {
+        return;
+    }
+
+    uint32_t age_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+    sample_count++;
+    total_us += age_us;
+    min_us = MIN(min_us, age_us);
+    max_us = MAX(max_us, age_us);
+
+    if (sample_count < REPORT_EVERY) {
+        return;
+    }
+
+    LOG_INF("Motion age over %d reports: min %d us, avg %d us, max %d us", sample_count, min_us,
+            (uint32_t)(total_us / sample_count), max_us);
+
+    sample_count = 0;
+    total_us = 0;
+    min_us = UINT32_MAX;
+    max_us = 0;
+}
+
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(TRACKBALL_NODE), report_age_input_callback);
+
+static int report_age_init(void) {
+    if (!gpio_is_ready_dt(&motion)) {
+        LOG_ERR("Motion GPIO not ready");
+        return -ENODEV;
+    }
+
+    gpio_init_callback(&motion_cb, motion_irq_handler, BIT(motion.pin));
+    return gpio_add_callback_dt(&motion, &motion_cb);
+}
+
+SYS_INIT(report_age_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
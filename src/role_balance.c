@@ -0,0 +1,74 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zmk/event_manager.h>
+#include <zmk/events/battery_state_changed.h>
+
+LOG_MODULE_REGISTER(role_balance, CONFIG_ZMK_LOG_LEVEL);
+
+#define IMBALANCE_THRESHOLD CONFIG_TORABO_ROLE_BALANCE_THRESHOLD
+#define IMBALANCE_SAMPLES CONFIG_TORABO_ROLE_BALANCE_SAMPLES
+
+// The split role is fixed at build time, so the central cannot hand its role
+// over at runtime: the host bonds live only on the central. Instead, watch both
+// battery levels and tell the user when reflashing the halves the other way
+// round would even out the drain.
+
+static int central_soc = -1;
+static int peripheral_soc = -1;
+static uint8_t imbalance_count = 0;
+static bool swap_recommended = false;
+
+static void evaluate_balance(void) {
+    if (central_soc < 0 || peripheral_soc < 0) {
+        return;
+    }
+
+    int imbalance = peripheral_soc - central_soc;
+
+    if (imbalance < IMBALANCE_THRESHOLD) {
+        imbalance_count = 0;
+        if (swap_recommended && imbalance <= IMBALANCE_THRESHOLD / 2) {
+            // Hysteresis so a level bouncing around the threshold stays quiet
+            swap_recommended = false;
+            LOG_INF("Battery levels balanced again (central %d%%, peripheral %d%%)",
+                    central_soc, peripheral_soc);
+        }
+        return;
+    }
+
+    if (imbalance_count < IMBALANCE_SAMPLES) {
+        imbalance_count++;
+    }
+
+    if (imbalance_count >= IMBALANCE_SAMPLES && !swap_recommended) {
+        swap_recommended = true;
+        LOG_WRN("Central battery %d%% is %d%% below peripheral %d%%: "
+                "flash the _central image to the other half to balance the drain",
+                central_soc, imbalance, peripheral_soc);
+    }
+}
+
+static int role_balance_listener(const zmk_event_t *eh) {
+    const struct zmk_battery_state_changed *ev = as_zmk_battery_state_changed(eh);
+    if (ev) {
+        central_soc = ev->state_of_charge;
+        evaluate_balance();
+        return ZMK_EV_EVENT_BUBBLE;
+    }
+
+    const struct zmk_peripheral_battery_state_changed *pev =
+        as_zmk_peripheral_battery_state_changed(eh);
+    if (pev && pev->source == 0) {
+        peripheral_soc = pev->state_of_charge;
+        evaluate_balance();
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(role_balance, role_balance_listener);
+ZMK_SUBSCRIPTION(role_balance, zmk_battery_state_changed);
+ZMK_SUBSCRIPTION(role_balance, zmk_peripheral_battery_state_changed);
@@ -0,0 +1,14 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#pragma once
+
+#include <stdint.h>
+
+#include "power_policy.h"
+
+// Replace the tier policy of the split link and re-evaluate the current tier
+void split_power_mgmt_set_policy(const struct power_policy *new_policy);
+
+// Time spent in each tier since boot
+void split_power_mgmt_get_residency(int64_t residency_ms[POWER_MODE_COUNT]);
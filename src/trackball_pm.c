@@ -0,0 +1,179 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/gpio.h>
+#include <zephyr/input/input.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/pm/device.h>
+#include <zmk/event_manager.h>
+
+#include "hot_path.h"
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+#include "power_mode_changed.h"
+#endif
+
+LOG_MODULE_REGISTER(trackball_pm, CONFIG_ZMK_LOG_LEVEL);
+
+// Put the trackball's SPI bus into its sleep pinctrl state between motion
+// bursts. The PAW3222 driver does not take runtime PM references around its
+// transfers, so the bus is suspended and resumed explicitly: the motion IRQ
+// resumes it before the driver's read is serviced, and it is suspended again
+// once no motion has been reported for a while.
+
+#define TRACKBALL_NODE DT_NODELABEL(trackball)
+#define IDLE_MS CONFIG_TORABO_TRACKBALL_PM_IDLE_MS
+
+static const struct device *const spi_bus = DEVICE_DT_GET(DT_BUS(TRACKBALL_NODE));
+static const struct gpio_dt_spec motion = GPIO_DT_SPEC_GET(TRACKBALL_NODE, irq_gpios);
+static struct gpio_callback motion_cb;
+static struct k_work_delayable suspend_work;
+static atomic_t bus_suspended = ATOMIC_INIT(0);
+
+// Time from a motion interrupt to the report carrying its deltas, kept apart
+// for interrupts that had to resume the bus and for those that found it up.
+// The difference is what suspending costs, including the SPIM re-init on the
+// first transfer, which the pinctrl switch alone would not show.
+struct report_latency {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+};
+
+static struct report_latency latency_resumed;
+static struct report_latency latency_awake;
+
+// Cycle count of the first motion interrupt not yet followed by a report, 0
+// when there is none. The two low bits carry flags instead: bit 0 is set if
+// that interrupt resumed the bus, and bit 1 always, so that a real timestamp
+// never reads as 0.
+#define IRQ_RESUMED BIT(0)
+#define IRQ_PENDING BIT(1)
+#define IRQ_FLAGS (IRQ_RESUMED | IRQ_PENDING)
+
+static atomic_t irq_cycles = ATOMIC_INIT(0);
+
+static TORABO_HOT_PATH bool resume_bus(void) {
+    if (!atomic_cas(&bus_suspended, 1, 0)) {
+        return false;
+    }
+
+    int err = pm_device_action_run(spi_bus, PM_DEVICE_ACTION_RESUME);
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to resume trackball bus: %d", err);
+    }
+
+    return true;
+}
+
+static uint32_t latency_avg_us(const struct report_latency *latency) {
+    return latency->count ? (uint32_t)(latency->total_us / latency->count) : 0;
+}
+
+static void suspend_bus(struct k_work *work) {
+    // Keep the motion ISR out until the flag matches the bus state
+    unsigned int key = irq_lock();
+
+    // Motion still pending means a read is about to follow
+    if (gpio_pin_get_dt(&motion) > 0) {
+        irq_unlock(key);
+        k_work_schedule(&suspend_work, K_MSEC(IDLE_MS));
+        return;
+    }
+
+    int err = pm_device_action_run(spi_bus, PM_DEVICE_ACTION_SUSPEND);
+    if (err == 0 || err == -EALREADY) {
+        atomic_set(&bus_suspended, 1);
+    }
+    irq_unlock(key);
+
+    if (err && err != -EALREADY) {
+        LOG_WRN("Failed to suspend trackball bus: %d", err);
+        return;
+    }
+
+    if (latency_resumed.count > 0) {
+        LOG_DBG("Trackball bus suspended, motion to report %d us avg (%d max) over %d resumes, "
+                "%d us avg (%d max) with the bus up",
+                latency_avg_us(&latency_resumed), latency_resumed.max_us, latency_resumed.count,
+                latency_avg_us(&latency_awake), latency_awake.max_us);
+    }
+}
+
+// Runs in the GPIO ISR alongside the sensor driver's own callback, which
+// only defers the read to a thread, so the bus is up before the read starts.
+// Pushing the suspend back here keeps a pending suspend from landing between
+// the interrupt and the read.
+static TORABO_HOT_PATH void motion_irq_handler(const struct device *port,
+                                               struct gpio_callback *cb, gpio_port_pins_t pins) {
+    uint32_t flags = resume_bus() ? IRQ_FLAGS : IRQ_PENDING;
+
+    k_work_reschedule(&suspend_work, K_MSEC(IDLE_MS));
+    atomic_cas(&irq_cycles, 0, (atomic_val_t)((k_cycle_get_32() & ~IRQ_FLAGS) | flags));
+}
+
+static void record_latency(void) {
+    uint32_t start = atomic_set(&irq_cycles, 0);
+    if (start == 0) {
+        return;
+    }
+
+    struct report_latency *latency = (start & IRQ_RESUMED) ? &latency_resumed : &latency_awake;
+    uint32_t elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - (start & ~IRQ_FLAGS));
+
+    latency->count++;
+    latency->total_us += elapsed_us;
+    latency->max_us = MAX(latency->max_us, elapsed_us);
+}
+
+static TORABO_HOT_PATH void trackball_pm_input_callback(struct input_event *evt) {
+    if (evt->sync) {
+        record_latency();
+    }
+
+    // Not straight away in the sleep tiers: the motion gate holds back the
+    // start of a burst, so the link only wakes some frames into it, and a
+    // suspend in between could land between two reads of the driver
+    k_work_reschedule(&suspend_work, K_MSEC(IDLE_MS));
+}
+
+INPUT_CALLBACK_DEFINE(DEVICE_DT_GET(TRACKBALL_NODE), trackball_pm_input_callback);
+
+#if IS_ENABLED(CONFIG_ZMK_SPLIT_ROLE_CENTRAL)
+static int trackball_pm_power_mode_listener(const zmk_event_t *eh) {
+    const struct torabo_power_mode_changed *ev = as_torabo_power_mode_changed(eh);
+
+    // In the sleep tiers nothing is moving, so drop the bus right away
+    if (ev->mode != POWER_MODE_ACTIVE && !atomic_get(&bus_suspended)) {
+        k_work_reschedule(&suspend_work, K_NO_WAIT);
+    }
+
+    return ZMK_EV_EVENT_BUBBLE;
+}
+
+ZMK_LISTENER(trackball_pm, trackball_pm_power_mode_listener);
+ZMK_SUBSCRIPTION(trackball_pm, torabo_power_mode_changed);
+#endif
+
+static int trackball_pm_init(void) {
+    if (!device_is_ready(spi_bus) || !gpio_is_ready_dt(&motion)) {
+        LOG_ERR("Trackball bus or motion GPIO not ready");
+        return -ENODEV;
+    }
+
+    k_work_init_delayable(&suspend_work, suspend_bus);
+
+    gpio_init_callback(&motion_cb, motion_irq_handler, BIT(motion.pin));
+    int err = gpio_add_callback_dt(&motion, &motion_cb);
+    if (err) {
+        LOG_ERR("Failed to add motion callback: %d", err);
+        return err;
+    }
+
+    k_work_schedule(&suspend_work, K_MSEC(IDLE_MS));
+    return 0;
+}
+
+SYS_INIT(trackball_pm_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
@@ -0,0 +1,432 @@
+// SPDX-License-Identifier: GPL-2.0-or-later
+// copyright (C) 2025 sekigon-gonnoc
+
+// Offline replay of the split power management in src/board.c.
+//
+// Build on the host:
+//   cmake -S tools/power_sim -B build/power_sim && cmake --build build/power_sim
+//
+// Capture a trace from a central built with CONFIG_TORABO_POWER_TRACE=y, then:
+//   build/power_sim/power_sim trace.log
+//   build/power_sim/power_sim --sweep trace.log
+//
+// The tier decisions come from src/power_policy.c, the same code the firmware
+// runs. The scheduling below mirrors power_mode_transition() and
+// reset_idle_timer() in board.c with an always-successful parameter update.
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "power_policy.h"
+
+#define CONN_INTERVAL_UNIT_US 1250
+#define DEFAULT_TAIL_MS 60000
+
+struct trace_event {
+    int64_t time;
+    char source;
+};
+
+struct trace {
+    struct trace_event *events;
+    size_t count;
+    size_t capacity;
+};
+
+struct sim_config {
+    uint16_t active_interval;
+    uint16_t active_latency;
+    int64_t tail_ms;
+};
+
+struct sim_result {
+    int64_t residency_ms[POWER_MODE_COUNT];
+    uint32_t param_updates;
+    // Connection events hosted by the central, and the subset the peripheral
+    // has to wake for when it has nothing to send (peripheral latency)
+    double central_events;
+    double peripheral_events;
+    uint32_t wakes;
+    int32_t worst_wake_us;
+    int64_t total_wake_us;
+};
+
+struct sim {
+    const struct power_policy *policy;
+    const struct sim_config *config;
+    struct sim_result *result;
+    enum power_mode mode;
+    int64_t now;
+    int64_t last_activity;
+    int64_t deadline; // pending power_mode_work, -1 when not scheduled
+};
+
+static void usage(const char *name) {
+    fprintf(stderr,
+            "usage: %s [options] <trace file | ->\n"
+            "  --timeouts T1,T2,T3   sleep1..sleep3 idle timeouts in ms (default %d,%d,%d)\n"
+            "  --mult M0,M1,M2,M3    interval multiplier per mode, up to %d (default 1,2,4,8)\n"
+            "  --interval N          active interval in 1.25 ms units (default 6)\n"
+            "  --latency N           active peripheral latency (default 30)\n"
+            "  --level N             apply power governor level N (%d..%d) to the policy\n"
+            "  --tail MS             idle time simulated after the last event (default %d)\n"
+            "  --sweep               compare a grid of timeout combinations\n"
+            "\n"
+            "Trace lines are \"<uptime ms> <k|t>\", optionally preceded by anything up to\n"
+            "\"trace \" so raw firmware logs can be used as they are.\n",
+            name, SLEEP1_TIMEOUT_MS, SLEEP2_TIMEOUT_MS, SLEEP3_TIMEOUT_MS,
+            POWER_POLICY_MAX_INTERVAL_MULT, POWER_POLICY_LEVEL_MIN, POWER_POLICY_LEVEL_MAX,
+            DEFAULT_TAIL_MS);
+}
+
+static int trace_append(struct trace *trace, int64_t time, char source) {
+    if (trace->count == trace->capacity) {
+        size_t capacity = trace->capacity ? trace->capacity * 2 : 4096;
+        struct trace_event *events = realloc(trace->events, capacity * sizeof(*events));
+        if (!events) {
+            return -1;
+        }
+        trace->events = events;
+        trace->capacity = capacity;
+    }
+
+    trace->events[trace->count++] = (struct trace_event){.time = time, .source = source};
+    return 0;
+}
+
+static int trace_load(FILE *file, struct trace *trace) {
+    char line[512];
+    int64_t offset = 0;
+    int64_t last_time = 0;
+
+    while (fgets(line, sizeof(line), file)) {
+        const char *start = strstr(line, "trace ");
+        long long time;
+        char source;
+
+        start = start ? start + strlen("trace ") : line;
+        if (sscanf(start, "%lld %c", &time, &source) != 2 || (source != 'k' && source != 't')) {
+            continue;
+        }
+
+        // Uptime restarts at zero after a reset; keep the replay monotonic
+        if (time + offset < last_time) {
+            offset = last_time - time;
+        }
+        last_time = time + offset;
+
+        if (trace_append(trace, last_time, source) < 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static uint16_t mode_interval(const struct sim *sim, enum power_mode mode, uint16_t *latency) {
+    uint16_t interval;
+
+    power_policy_conn_param(sim->policy, mode, sim->config->active_interval,
+                            sim->config->active_latency, &interval, latency);
+    return interval;
+}
+
+// Account the time until `until` to the current mode
+static void sim_advance(struct sim *sim, int64_t until) {
+    int64_t elapsed = until - sim->now;
+    uint16_t latency;
+    uint16_t interval = mode_interval(sim, sim->mode, &latency);
+    double events = (double)elapsed * 1000 / (interval * CONN_INTERVAL_UNIT_US);
+
+    sim->result->residency_ms[sim->mode] += elapsed;
+    sim->result->central_events += events;
+    sim->result->peripheral_events += events / (latency + 1);
+    sim->now = until;
+}
+
+// Mirrors power_mode_transition() in board.c
+static void sim_transition(struct sim *sim) {
+    int64_t idle_time = sim->now - sim->last_activity;
+    enum power_mode target_mode = power_policy_target_mode(sim->policy, idle_time);
+
+    if (target_mode != sim->mode) {
+        sim->mode = target_mode;
+        sim->result->param_updates++;
+    }
+
+    int32_t next_timeout = power_policy_next_timeout(sim->policy, sim->mode, idle_time);
+    sim->deadline = next_timeout > 0 ? sim->now + next_timeout : -1;
+}
+
+// Mirrors reset_idle_timer() in board.c
+static void sim_activity(struct sim *sim) {
+    sim->last_activity = sim->now;
+    sim->deadline = -1;
+
+    if (sim->mode != POWER_MODE_ACTIVE) {
+        // The event that wakes the link waits for the next event of the
+        // current, slower interval before the update takes effect
+        uint16_t latency;
+        int32_t wake_us = mode_interval(sim, sim->mode, &latency) * CONN_INTERVAL_UNIT_US;
+
+        sim->result->wakes++;
+        sim->result->total_wake_us += wake_us;
+        if (wake_us > sim->result->worst_wake_us) {
+            sim->result->worst_wake_us = wake_us;
+        }
+
+        sim_transition(sim);
+    } else {
+        sim->deadline = sim->now + sim->policy->sleep_timeout_ms[0];
+    }
+}
+
+static void simulate(const struct trace *trace, const struct power_policy *policy,
+                     const struct sim_config *config, struct sim_result *result) {
+    memset(result, 0, sizeof(*result));
+
+    if (trace->count == 0) {
+        return;
+    }
+
+    // The split link comes up active, as in power_mgmt_bt_conn_connected_cb()
+    struct sim sim = {
+        .policy = policy,
+        .config = config,
+        .result = result,
+        .mode = POWER_MODE_ACTIVE,
+        .now = trace->events[0].time,
+        .last_activity = trace->events[0].time,
+        .deadline = trace->events[0].time + policy->sleep_timeout_ms[0],
+    };
+    int64_t end = trace->events[trace->count - 1].time + config->tail_ms;
+
+    for (size_t i = 0; i <= trace->count; i++) {
+        int64_t time = i < trace->count ? trace->events[i].time : end;
+
+        while (sim.deadline >= 0 && sim.deadline <= time) {
+            sim_advance(&sim, sim.deadline);
+            sim_transition(&sim);
+        }
+
+        sim_advance(&sim, time);
+        if (i < trace->count) {
+            sim_activity(&sim);
+        }
+    }
+}
+
+static void print_header(void) {
+    printf("%-20s %7s %7s %7s %7s %8s %13s %10s %10s\n", "timeouts_ms", "active%", "sleep1%",
+           "sleep2%", "sleep3%", "updates", "periph_events", "worst_wake", "mean_wake");
+}
+
+static void print_result(const struct power_policy *policy, const struct sim_result *result) {
+    char timeouts[32];
+    int64_t total = 0;
+
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        total += result->residency_ms[mode];
+    }
+    if (total == 0) {
+        total = 1;
+    }
+
+    snprintf(timeouts, sizeof(timeouts), "%d,%d,%d", policy->sleep_timeout_ms[0],
+             policy->sleep_timeout_ms[1], policy->sleep_timeout_ms[2]);
+    printf("%-20s", timeouts);
+    for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+        printf(" %7.2f", 100.0 * result->residency_ms[mode] / total);
+    }
+    printf(" %8u %13.0f %8.2fms %8.2fms\n", result->param_updates, result->peripheral_events,
+           result->worst_wake_us / 1000.0,
+           result->wakes ? result->total_wake_us / 1000.0 / result->wakes : 0.0);
+}
+
+struct sweep_entry {
+    struct power_policy policy;
+    struct sim_result result;
+};
+
+static int compare_sweep_entry(const void *a, const void *b) {
+    const struct sweep_entry *ea = a;
+    const struct sweep_entry *eb = b;
+
+    if (ea->result.peripheral_events != eb->result.peripheral_events) {
+        return ea->result.peripheral_events < eb->result.peripheral_events ? -1 : 1;
+    }
+    return ea->result.worst_wake_us - eb->result.worst_wake_us;
+}
+
+// The grid sets the timeouts of the unscaled policy, and each combination is
+// then scaled to the governor level like a single run
+static int run_sweep(const struct trace *trace, const struct power_policy *base, int level,
+                     const struct sim_config *config) {
+    static const int32_t sleep1[] = {1000, 2000, 5000, 10000, 20000};
+    static const int32_t sleep2_step[] = {5000, 10000, 30000, 60000};
+    static const int32_t sleep3_step[] = {15000, 30000, 60000, 120000};
+    size_t count = 0;
+    struct sweep_entry *entries =
+        calloc(sizeof(sleep1) / sizeof(sleep1[0]) * sizeof(sleep2_step) / sizeof(sleep2_step[0]) *
+                   sizeof(sleep3_step) / sizeof(sleep3_step[0]),
+               sizeof(*entries));
+
+    if (!entries) {
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(sleep1) / sizeof(sleep1[0]); i++) {
+        for (size_t j = 0; j < sizeof(sleep2_step) / sizeof(sleep2_step[0]); j++) {
+            for (size_t k = 0; k < sizeof(sleep3_step) / sizeof(sleep3_step[0]); k++) {
+                struct sweep_entry *entry = &entries[count++];
+
+                struct power_policy swept = *base;
+
+                swept.sleep_timeout_ms[0] = sleep1[i];
+                swept.sleep_timeout_ms[1] = sleep1[i] + sleep2_step[j];
+                swept.sleep_timeout_ms[2] = sleep1[i] + sleep2_step[j] + sleep3_step[k];
+                power_policy_scale(&entry->policy, &swept, level);
+                simulate(trace, &entry->policy, config, &entry->result);
+            }
+        }
+    }
+
+    qsort(entries, count, sizeof(*entries), compare_sweep_entry);
+
+    print_header();
+    for (size_t i = 0; i < count; i++) {
+        print_result(&entries[i].policy, &entries[i].result);
+    }
+
+    free(entries);
+    return 0;
+}
+
+static bool parse_list(const char *arg, long *values, int count) {
+    char *end;
+
+    for (int i = 0; i < count; i++) {
+        values[i] = strtol(arg, &end, 10);
+        if (end == arg || (i < count - 1 && *end != ',') || values[i] <= 0) {
+            return false;
+        }
+        arg = end + 1;
+    }
+
+    return *end == '\0';
+}
+
+int main(int argc, char **argv) {
+    struct power_policy policy = POWER_POLICY_DEFAULT;
+    struct sim_config config = {
+        .active_interval = 6,
+        .active_latency = 30,
+        .tail_ms = DEFAULT_TAIL_MS,
+    };
+    bool sweep = false;
+    int level = 0;
+    const char *path = NULL;
+    long values[POWER_MODE_COUNT];
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--sweep") == 0) {
+            sweep = true;
+        } else if (strcmp(arg, "--timeouts") == 0 && value) {
+            if (!parse_list(value, values, POWER_MODE_COUNT - 1)) {
+                usage(argv[0]);
+                return 2;
+            }
+            for (int mode = 0; mode < POWER_MODE_COUNT - 1; mode++) {
+                policy.sleep_timeout_ms[mode] = values[mode];
+            }
+            i++;
+        } else if (strcmp(arg, "--mult") == 0 && value) {
+            if (!parse_list(value, values, POWER_MODE_COUNT)) {
+                usage(argv[0]);
+                return 2;
+            }
+            for (int mode = 0; mode < POWER_MODE_COUNT; mode++) {
+                if (values[mode] > POWER_POLICY_MAX_INTERVAL_MULT) {
+                    fprintf(stderr, "interval multiplier %ld is above the maximum of %d\n",
+                            values[mode], POWER_POLICY_MAX_INTERVAL_MULT);
+                    return 2;
+                }
+                policy.interval_mult[mode] = values[mode];
+            }
+            i++;
+        } else if (strcmp(arg, "--interval") == 0 && value) {
+            config.active_interval = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--latency") == 0 && value) {
+            config.active_latency = atoi(value);
+            i++;
+        } else if (strcmp(arg, "--level") == 0 && value) {
+            level = atoi(value);
+            if (level < POWER_POLICY_LEVEL_MIN || level > POWER_POLICY_LEVEL_MAX) {
+                usage(argv[0]);
+                return 2;
+            }
+            i++;
+        } else if (strcmp(arg, "--tail") == 0 && value) {
+            config.tail_ms = atoll(value);
+            i++;
+        } else if (arg[0] != '-' || strcmp(arg, "-") == 0) {
+            path = arg;
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    if (!path || config.active_interval == 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    struct power_policy base = policy;
+    power_policy_scale(&policy, &base, level);
+
+    FILE *file = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+    if (!file) {
+        perror(path);
+        return 1;
+    }
+
+    struct trace trace = {0};
+    int err = trace_load(file, &trace);
+    if (file != stdin) {
+        fclose(file);
+    }
+    if (err < 0) {
+        fprintf(stderr, "out of memory while loading %s\n", path);
+        return 1;
+    }
+
+    size_t keys = 0;
+    for (size_t i = 0; i < trace.count; i++) {
+        keys += trace.events[i].source == 'k';
+    }
+    printf("trace: %zu events (%zu key, %zu trackball), %.1f h\n", trace.count, keys,
+           trace.count - keys,
+           trace.count ? (trace.events[trace.count - 1].time - trace.events[0].time) / 3600000.0
+                       : 0.0);
+
+    if (sweep) {
+        err = run_sweep(&trace, &base, level, &config);
+    } else {
+        struct sim_result result;
+
+        simulate(&trace, &policy, &config, &result);
+        print_header();
+        print_result(&policy, &result);
+    }
+
+    free(trace.events);
+    return err < 0 ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: GPL-2.0-or-later
+# copyright (C) 2025 sekigon-gonnoc
+
+"""List the functions linked into RAM by CONFIG_TORABO_HOT_PATH_RAM.
+
+Run after every build with the option enabled, or by hand:
+
+    python3 tools/ram_text_report.py build/zephyr/zephyr.elf
+
+Every function symbol placed in an executable section at or above the RAM
+base is printed with its size, grouped by section, followed by the total RAM
+the moved code takes.
+"""
+
+import argparse
+import sys
+
+from elftools.elf.constants import SH_FLAGS
+from elftools.elf.elffile import ELFFile
+
+NRF52_RAM_BASE = 0x20000000
+
+
+def ram_text_sections(elf, ram_base):
+    sections = {}
+    for index, section in enumerate(elf.iter_sections()):
+        flags = section["sh_flags"]
+        if (flags & SH_FLAGS.SHF_ALLOC and flags & SH_FLAGS.SHF_EXECINSTR
+                and section["sh_addr"] >= ram_base):
+            sections[index] = section.name
+    return sections
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("elf", help="zephyr.elf of the build")
+    parser.add_argument("--ram-base", type=lambda v: int(v, 0), default=NRF52_RAM_BASE,
+                        help="start address of RAM (default 0x%x)" % NRF52_RAM_BASE)
+    args = parser.parse_args()
+
+    with open(args.elf, "rb") as f:
+        elf = ELFFile(f)
+        sections = ram_text_sections(elf, args.ram_base)
+        symtab = elf.get_section_by_name(".symtab")
+        if symtab is None:
+            sys.exit("%s has no symbol table" % args.elf)
+
+        functions = {}
+        for symbol in symtab.iter_symbols():
+            index = symbol["st_shndx"]
+            if symbol["st_info"]["type"] != "STT_FUNC" or index not in sections:
+                continue
+            functions.setdefault(sections[index], []).append(
+                (symbol["st_value"] & ~1, symbol["st_size"], symbol.name))
+
+    total = 0
+    print("Functions linked into RAM:")
+    for section, entries in sorted(functions.items()):
+        print("  %s" % section)
+        for address, size, name in sorted(entries):
+            print("    0x%08x %6d  %s" % (address, size, name))
+            total += size
+
+    print("Total: %d bytes of code in RAM" % total)
+
+
+if __name__ == "__main__":
+    main()